@@ -7,16 +7,22 @@
 #include <zephyr.h>
 #include <zephyr/types.h>
 #include <errno.h>
-#include <net/socket.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <device.h>
+#include <at_cmd.h>
+#include <lte_lc.h>
 #include <logging/log.h>
 
 LOG_MODULE_REGISTER(lte_lc, CONFIG_LTE_LINK_CONTROL_LOG_LEVEL);
 
-#define LC_MAX_READ_LENGTH 128
-#define AT_CMD_SIZE(x) (sizeof(x) - 1)
+#define CEREG_STAT_INDEX 0
+#define CEREG_TAC_INDEX 1
+#define CEREG_CELL_ID_INDEX 2
+#define CEREG_ACT_INDEX 3
+/* Cell ID is 28 bits, as eight hex characters. */
+#define CEREG_HEX_STR_MAX 8
 
 /* Subscribes to notifications with level 2 */
 static const char subscribe[] = "AT+CEREG=2";
@@ -41,13 +47,8 @@ static const char power_off[] = "AT+CFUN=0";
 static const char normal[] = "AT+CFUN=1";
 /* Set the modem to Offline mode */
 static const char offline[] = "AT+CFUN=4";
-/* Successful return from modem */
-static const char success[] = "OK";
-/* Accepted network statuses read from modem */
-static const char status1[] = "+CEREG: 1";
-static const char status2[] = "+CEREG:1";
-static const char status3[] = "+CEREG: 5";
-static const char status4[] = "+CEREG:5";
+/* Network registration status notification */
+static const char cereg_prefix[] = "+CEREG";
 
 #if defined(CONFIG_LTE_PDP_CMD) && defined(CONFIG_LTE_PDP_CONTEXT)
 static const char cgdcont[] = "AT+CGDCONT="CONFIG_LTE_PDP_CONTEXT;
@@ -56,106 +57,306 @@ static const char cgdcont[] = "AT+CGDCONT="CONFIG_LTE_PDP_CONTEXT;
 static const char legacy_pco[] = "AT%XEPCO=0";
 #endif
 
-static int at_cmd(int fd, const char *cmd, size_t size)
+/* Commands sent to connect, in order. Band lock is a volatile setting and
+ * has to be set every time before activating the modem.
+ */
+static const char *const connect_cmds[] = {
+#if defined(CONFIG_LTE_EDRX_REQ)
+	edrx_req,
+#endif
+	subscribe,
+#if defined(CONFIG_LTE_LOCK_BANDS)
+	lock_bands,
+#endif
+#if defined(CONFIG_LTE_LEGACY_PCO_MODE)
+	legacy_pco,
+#endif
+#if defined(CONFIG_LTE_PDP_CMD)
+	cgdcont,
+#endif
+	normal,
+};
+
+static K_SEM_DEFINE(link, 0, 1);
+static K_MUTEX_DEFINE(state_lock);
+
+static lte_lc_evt_handler_t evt_handler;
+static struct lte_lc_nw_reg_info nw_reg;
+/* Connecting was started and has not finished yet. */
+static bool connecting;
+/* Connect commands are queued in the AT command service. */
+static bool cmds_pending;
+static size_t cmd_idx;
+static int connect_result;
+static struct at_cmd_request connect_req;
+static struct k_delayed_work timeout_work;
+
+static int at_cmd(const char *cmd)
 {
-	int len;
-	u8_t buffer[LC_MAX_READ_LENGTH];
+	enum at_cmd_state state;
+	int err;
 
-	LOG_DBG("send: %s", cmd);
-	len = send(fd, cmd, size, 0);
-	if (len != size) {
-		LOG_ERR("send: failed");
+	err = at_cmd_write(cmd, NULL, 0, &state);
+	if (err) {
+		LOG_ERR("%s failed (err: %d, state: %d)", log_strdup(cmd), err,
+			state);
 		return -EIO;
 	}
 
-	len = recv(fd, buffer, LC_MAX_READ_LENGTH, 0);
-	if ((len < AT_CMD_SIZE(success)) ||
-	    (memcmp(success, buffer, AT_CMD_SIZE(success)) != 0)) {
-		LOG_ERR("recv: %s", buffer);
-		return -EIO;
+	return 0;
+}
+
+static bool is_registered(enum lte_lc_nw_reg_status status)
+{
+	return (status == LTE_LC_NW_REG_REGISTERED_HOME) ||
+	       (status == LTE_LC_NW_REG_REGISTERED_ROAMING);
+}
+
+static void evt_send(enum lte_lc_evt_type type, int err)
+{
+	struct lte_lc_evt evt = {
+		.type = type,
+		.err = err,
+	};
+	lte_lc_evt_handler_t handler;
+
+	k_mutex_lock(&state_lock, K_FOREVER);
+	evt.nw_reg = nw_reg;
+	handler = evt_handler;
+	k_mutex_unlock(&state_lock);
+
+	if (handler) {
+		handler(&evt);
 	}
+}
 
-	return 0;
+/* Finish connecting, unless it has already finished. */
+static void connect_finish(int err)
+{
+	bool finished = false;
+
+	k_mutex_lock(&state_lock, K_FOREVER);
+	if (connecting) {
+		connecting = false;
+		connect_result = err;
+		finished = true;
+	}
+	k_mutex_unlock(&state_lock);
+
+	if (!finished) {
+		return;
+	}
+
+	/* Work may already be running, which finds nothing to finish. */
+	k_delayed_work_cancel(&timeout_work);
+
+	if (err) {
+		LOG_ERR("Connecting failed, err: %d", err);
+	} else {
+		LOG_DBG("Registered to network");
+	}
+
+	k_sem_give(&link);
+	evt_send(err ? LTE_LC_EVT_CONNECT_FAILED : LTE_LC_EVT_CONNECTED, err);
 }
 
-static int w_lte_lc_init_and_connect(struct device *unused)
+static void timeout_work_fn(struct k_work *work)
 {
-	int err;
-	int at_socket_fd;
+	ARG_UNUSED(work);
 
-	u8_t buffer[LC_MAX_READ_LENGTH];
+	connect_finish(-ETIMEDOUT);
+}
 
-	at_socket_fd = socket(AF_LTE, 0, NPROTO_AT);
-	if (at_socket_fd == -1) {
-		return -EFAULT;
+static u32_t hex_param_get(struct at_param_list *list, size_t index)
+{
+	/* Copied string is not null terminated. */
+	char str[CEREG_HEX_STR_MAX + 1] = { 0 };
+
+	if (at_params_string_get(list, index, str, sizeof(str) - 1) < 0) {
+		return 0;
 	}
 
-#if defined(CONFIG_LTE_EDRX_REQ)
-	/* Request configured eDRX settings to save power */
-	err = at_cmd(at_socket_fd, edrx_req, AT_CMD_SIZE(edrx_req));
+	return strtoul(str, NULL, 16);
+}
+
+static void cereg_handler(const char *prefix, struct at_param_list *list,
+			  void *user_data)
+{
+	struct lte_lc_nw_reg_info info = { 0 };
+	u16_t status;
+	u16_t act;
+	bool changed;
+	bool registered;
+
+	ARG_UNUSED(prefix);
+	ARG_UNUSED(user_data);
+
+	if (at_params_short_get(list, CEREG_STAT_INDEX, &status)) {
+		return;
+	}
+
+	/* Cell is reported only when registered or searching on a cell. */
+	info.status = status;
+	info.tac = hex_param_get(list, CEREG_TAC_INDEX);
+	info.cell_id = hex_param_get(list, CEREG_CELL_ID_INDEX);
+	if (at_params_short_get(list, CEREG_ACT_INDEX, &act) == 0) {
+		info.mode = act;
+	}
+
+	LOG_DBG("Registration status: %d, tac: 0x%x, cell: 0x%x, mode: %d",
+		info.status, info.tac, info.cell_id, info.mode);
+
+	k_mutex_lock(&state_lock, K_FOREVER);
+	changed = (info.status != nw_reg.status) ||
+		  (info.tac != nw_reg.tac) ||
+		  (info.cell_id != nw_reg.cell_id) ||
+		  (info.mode != nw_reg.mode);
+	nw_reg = info;
+	/* Registration counts once the modem is activated. */
+	registered = connecting && !cmds_pending && is_registered(info.status);
+	k_mutex_unlock(&state_lock);
+
+	if (changed) {
+		evt_send(LTE_LC_EVT_NW_REG_STATUS, 0);
+	}
+
+	if (registered) {
+		connect_finish(0);
+	}
+}
+
+static struct at_cmd_urc_subscriber cereg_sub = {
+	.prefix = cereg_prefix,
+	.handler = cereg_handler,
+};
+
+static void connect_cmd_done(struct at_cmd_request *req)
+{
+	bool chain_end;
+	bool registered = false;
+	int err = req->result;
+
 	if (err) {
-		close(at_socket_fd);
-		return err;
+		LOG_ERR("%s failed (err: %d, state: %d)", log_strdup(req->cmd),
+			err, req->state);
+		err = -EIO;
 	}
-#endif
-	err = at_cmd(at_socket_fd, subscribe, AT_CMD_SIZE(subscribe));
+
+	k_mutex_lock(&state_lock, K_FOREVER);
+	/* Remaining commands are not sent if connecting has timed out. */
+	chain_end = err || !connecting ||
+		    (++cmd_idx == ARRAY_SIZE(connect_cmds));
+	if (chain_end) {
+		cmds_pending = false;
+		registered = is_registered(nw_reg.status);
+	}
+	k_mutex_unlock(&state_lock);
+
 	if (err) {
-		close(at_socket_fd);
-		return err;
+		connect_finish(err);
+		return;
 	}
 
-#if defined(CONFIG_LTE_LOCK_BANDS)
-	/* Set LTE band lock (volatile setting).
-	 * Has to be done every time before activating the modem.
+	if (!chain_end) {
+		req->cmd = connect_cmds[cmd_idx];
+		err = at_cmd_submit(req);
+		if (err) {
+			k_mutex_lock(&state_lock, K_FOREVER);
+			cmds_pending = false;
+			k_mutex_unlock(&state_lock);
+			connect_finish(err);
+		}
+		return;
+	}
+
+	/* Registration may have been reported while the modem was being
+	 * activated.
 	 */
-	err = at_cmd(at_socket_fd, lock_bands, AT_CMD_SIZE(lock_bands));
-	if (err) {
-		close(at_socket_fd);
-		return err;
+	if (registered) {
+		connect_finish(0);
 	}
-#endif
-#if defined(CONFIG_LTE_LEGACY_PCO_MODE)
-	err = at_cmd(at_socket_fd, legacy_pco, AT_CMD_SIZE(legacy_pco));
-	if (err) {
-		close(at_socket_fd);
+}
+
+void lte_lc_register_handler(lte_lc_evt_handler_t handler)
+{
+	k_mutex_lock(&state_lock, K_FOREVER);
+	evt_handler = handler;
+	k_mutex_unlock(&state_lock);
+}
+
+int lte_lc_init_and_connect_async(s32_t timeout)
+{
+	static bool initialized;
+	int err;
+
+	/* Notifications are read by the AT command service. Subscribing is
+	 * done without the state lock, which is taken by the handler.
+	 */
+	err = at_cmd_urc_subscribe(&cereg_sub);
+	if (err && (err != -EALREADY)) {
 		return err;
 	}
+
+	k_mutex_lock(&state_lock, K_FOREVER);
+
+	if (connecting || cmds_pending) {
+		k_mutex_unlock(&state_lock);
+		return -EINPROGRESS;
+	}
+
+	if (!initialized) {
+		k_delayed_work_init(&timeout_work, timeout_work_fn);
+		initialized = true;
+	}
+
+#if defined(CONFIG_LTE_LEGACY_PCO_MODE)
 	LOG_INF("Using legacy LTE PCO mode...");
 #endif
 #if defined(CONFIG_LTE_PDP_CMD)
-	err = at_cmd(at_socket_fd, cgdcont, AT_CMD_SIZE(cgdcont));
-	if (err) {
-		close(at_socket_fd);
-		return err;
-	}
 	LOG_INF("PDP Context: %s", cgdcont);
 #endif
-	err = at_cmd(at_socket_fd, normal, AT_CMD_SIZE(normal));
+
+	cmd_idx = 0;
+	memset(&connect_req, 0, sizeof(connect_req));
+	connect_req.cmd = connect_cmds[0];
+	connect_req.done = connect_cmd_done;
+
+	connecting = true;
+	cmds_pending = true;
+	k_sem_reset(&link);
+
+	err = at_cmd_submit(&connect_req);
 	if (err) {
-		close(at_socket_fd);
+		connecting = false;
+		cmds_pending = false;
+		k_mutex_unlock(&state_lock);
 		return err;
 	}
 
-	while (true) {
-		int bytes;
-
-		bytes = recv(at_socket_fd, buffer, LC_MAX_READ_LENGTH, 0);
-		if (bytes) {
-			LOG_DBG("recv: %s", buffer);
-			if (!memcmp(status1, buffer, AT_CMD_SIZE(status1)) ||
-			    !memcmp(status2, buffer, AT_CMD_SIZE(status2)) ||
-			    !memcmp(status3, buffer, AT_CMD_SIZE(status3)) ||
-			    !memcmp(status4, buffer, AT_CMD_SIZE(status4))) {
-				break;
-			}
-		}
-		k_sleep(K_MSEC(10));
+	if (timeout != K_FOREVER) {
+		k_delayed_work_submit(&timeout_work, timeout);
 	}
 
-	close(at_socket_fd);
+	k_mutex_unlock(&state_lock);
+
 	return 0;
 }
 
+static int w_lte_lc_init_and_connect(struct device *unused)
+{
+	int err;
+
+	err = lte_lc_init_and_connect_async(
+			K_SECONDS(CONFIG_LTE_NETWORK_TIMEOUT));
+	if (err) {
+		return err;
+	}
+
+	k_sem_take(&link, K_FOREVER);
+
+	return connect_result;
+}
+
 /* lte lc Init and connect wrapper */
 int lte_lc_init_and_connect(void)
 {
@@ -166,102 +367,42 @@ int lte_lc_init_and_connect(void)
 	return err;
 }
 
-int lte_lc_offline(void)
+int lte_lc_nw_reg_info_get(struct lte_lc_nw_reg_info *info)
 {
-	int err;
-	int at_socket_fd;
-
-	at_socket_fd = socket(AF_LTE, 0, NPROTO_AT);
-	if (at_socket_fd == -1) {
-		return -EFAULT;
+	if (info == NULL) {
+		return -EINVAL;
 	}
 
-	err = at_cmd(at_socket_fd, offline, AT_CMD_SIZE(offline));
-	close(at_socket_fd);
+	k_mutex_lock(&state_lock, K_FOREVER);
+	*info = nw_reg;
+	k_mutex_unlock(&state_lock);
 
-	return err;
+	return 0;
 }
 
-int lte_lc_power_off(void)
+int lte_lc_offline(void)
 {
-	int err;
-	int at_socket_fd;
-
-	at_socket_fd = socket(AF_LTE, 0, NPROTO_AT);
-	if (at_socket_fd == -1) {
-		return -EFAULT;
-	}
-
-	err = at_cmd(at_socket_fd, power_off, AT_CMD_SIZE(power_off));
-	close(at_socket_fd);
+	return at_cmd(offline);
+}
 
-	return err;
+int lte_lc_power_off(void)
+{
+	return at_cmd(power_off);
 }
 
 int lte_lc_normal(void)
 {
-	int err;
-	int at_socket_fd;
-
-	at_socket_fd = socket(AF_LTE, 0, NPROTO_AT);
-	if (at_socket_fd == -1) {
-		return -EFAULT;
-	}
-
-	err = at_cmd(at_socket_fd, normal, AT_CMD_SIZE(normal));
-	close(at_socket_fd);
-
-	return err;
+	return at_cmd(normal);
 }
 
 int lte_lc_psm_req(bool enable)
 {
-	int err;
-	int at_socket_fd;
-	const char *cmd;
-	size_t size;
-
-	at_socket_fd = socket(AF_LTE, 0, NPROTO_AT);
-	if (at_socket_fd == -1) {
-		return -EFAULT;
-	}
-	if (enable) {
-		cmd = psm_req;
-		size = AT_CMD_SIZE(psm_req);
-	} else {
-		cmd = psm_disable;
-		size = AT_CMD_SIZE(psm_disable);
-	}
-
-	err = at_cmd(at_socket_fd, cmd, size);
-	close(at_socket_fd);
-
-	return err;
+	return at_cmd(enable ? psm_req : psm_disable);
 }
 
 int lte_lc_edrx_req(bool enable)
 {
-	int err;
-	int at_socket_fd;
-	const char *cmd;
-	size_t size;
-
-	at_socket_fd = socket(AF_LTE, 0, NPROTO_AT);
-	if (at_socket_fd == -1) {
-		return -EFAULT;
-	}
-	if (enable) {
-		cmd = edrx_req;
-		size = AT_CMD_SIZE(edrx_req);
-	} else {
-		cmd = edrx_disable;
-		size = AT_CMD_SIZE(edrx_disable);
-	}
-
-	err = at_cmd(at_socket_fd, cmd, size);
-	close(at_socket_fd);
-
-	return err;
+	return at_cmd(enable ? edrx_req : edrx_disable);
 }
 
 #if defined(CONFIG_LTE_AUTO_INIT_AND_CONNECT)
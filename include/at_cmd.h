@@ -0,0 +1,195 @@
+/**
+ * @file at_cmd.h
+ *
+ * @brief Public APIs for the AT command service.
+ */
+
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef ZEPHYR_INCLUDE_AT_CMD_H_
+#define ZEPHYR_INCLUDE_AT_CMD_H_
+
+/**
+ * @defgroup at_cmd AT command service
+ * @{
+ * @brief Service that owns the AT socket and shares it between modules.
+ */
+
+#include <kernel.h>
+#include <zephyr/types.h>
+#include <misc/slist.h>
+#include <at_cmd_parser.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Final result code of an AT command. */
+enum at_cmd_state {
+	AT_CMD_OK,		/**< Command was executed (OK). */
+	AT_CMD_ERROR,		/**< Command was rejected (ERROR). */
+	AT_CMD_ERROR_CME,	/**< Equipment error (+CME ERROR). */
+	AT_CMD_ERROR_CMS,	/**< Message service error (+CMS ERROR). */
+};
+
+struct at_cmd_request;
+
+/**
+ * @brief Completion callback of an AT command request.
+ *
+ * The callback is called from the thread of the AT command service, or from
+ * the system work queue if the command timed out.
+ * It must not wait for other AT commands to complete.
+ *
+ * @param req Completed request.
+ */
+typedef void (*at_cmd_done_cb_t)(struct at_cmd_request *req);
+
+/**
+ * @brief AT command request.
+ *
+ * The request and the buffers it points to must be valid until the request
+ * is completed.
+ */
+struct at_cmd_request {
+	/** Used by the service to queue the request. */
+	sys_snode_t node;
+
+	/** Null terminated AT command. */
+	const char *cmd;
+
+	/** Buffer for the response, including the final result code.
+	 *  Can be NULL if the response is not needed.
+	 */
+	char *resp;
+
+	/** Size of the response buffer. */
+	size_t resp_size;
+
+	/** Completion callback, can be NULL. */
+	at_cmd_done_cb_t done;
+
+	/** Signal raised with the result on completion, can be NULL. */
+	struct k_poll_signal *signal;
+
+	/** User data, not used by the service. */
+	void *user_data;
+
+	/** Length of the response stored in the response buffer. */
+	size_t resp_len;
+
+	/** Final result code received from the modem. */
+	enum at_cmd_state state;
+
+	/** Error code of the +CME ERROR or +CMS ERROR final result code. */
+	int error_code;
+
+	/** Zero if the modem returned OK or (negative) error code otherwise. */
+	int result;
+};
+
+/**
+ * @brief Subscriber of unsolicited result codes.
+ *
+ * Parameters of the unsolicited result codes with the given prefix
+ * (for example "+CEREG") are parsed and passed to the handler.
+ */
+struct at_cmd_urc_subscriber {
+	/** Used by the service to store the subscriber. */
+	sys_snode_t node;
+
+	/** Prefix of the unsolicited result code. */
+	const char *prefix;
+
+	/** Handler called from the thread of the AT command service. */
+	at_parser_handler_t handler;
+
+	/** User data passed to the handler. */
+	void *user_data;
+};
+
+/**
+ * @brief Handler of raw data received from the modem, that is not a response
+ * to a command.
+ *
+ * @param data Received data, null terminated.
+ * @param len  Length of the received data.
+ */
+typedef void (*at_cmd_monitor_t)(const char *data, size_t len);
+
+/**
+ * @brief Queue an AT command.
+ *
+ * The function does not wait for the response. Commands are sent one after
+ * another, in the order of submission. When the final result code is
+ * received, the result is stored in the request, the completion callback is
+ * called and the signal is raised with the result. If the final result code
+ * is not received within CONFIG_AT_CMD_RESPONSE_TIMEOUT, the result is
+ * -ETIMEDOUT. The final result code received later is discarded and does
+ * not complete the next command.
+ *
+ * @param req AT command request.
+ *
+ * @retval 0 If the request was queued.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_cmd_submit(struct at_cmd_request *req);
+
+/**
+ * @brief Send an AT command and wait for the response.
+ *
+ * @param cmd       Null terminated AT command.
+ * @param resp      Buffer for the response, can be NULL.
+ * @param resp_size Size of the response buffer.
+ * @param state     Final result code of the command, can be NULL.
+ *
+ * @retval 0 If the modem returned OK.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_cmd_write(const char *cmd, char *resp, size_t resp_size,
+		 enum at_cmd_state *state);
+
+/**
+ * @brief Subscribe to unsolicited result codes with a given prefix.
+ *
+ * @param sub Subscriber. Must be valid until it is unsubscribed.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_cmd_urc_subscribe(struct at_cmd_urc_subscriber *sub);
+
+/**
+ * @brief Unsubscribe from unsolicited result codes.
+ *
+ * @param sub Subscriber.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_cmd_urc_unsubscribe(struct at_cmd_urc_subscriber *sub);
+
+/**
+ * @brief Set handler of all data received from the modem, that is not
+ * a response to a command.
+ *
+ * Unsolicited result codes are passed to the monitor before they are
+ * dispatched to the subscribers.
+ *
+ * @param monitor Handler, NULL to remove the handler.
+ */
+void at_cmd_monitor_set(at_cmd_monitor_t monitor);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_AT_CMD_H_ */
@@ -14,6 +14,7 @@
  * @{
  */
 
+#include <stdbool.h>
 #include <stdlib.h>
 #include <zephyr/types.h>
 #include <at_params.h>
@@ -72,6 +73,96 @@ int at_parser_max_params_from_str(char *at_params_str,
 int at_parser_params_from_str(char *at_params_str,
 				struct at_param_list *list);
 
+
+/**
+ * @brief Handler of AT command responses or notifications with a prefix.
+ *
+ * @param prefix    Prefix of the response, for example "+CEREG".
+ * @param list      Parsed parameters of the response.
+ * @param user_data User data passed to @ref at_parser_stream_init.
+ */
+typedef void (*at_parser_handler_t)(const char *prefix,
+				    struct at_param_list *list,
+				    void *user_data);
+
+/** @brief Handler of responses with a given prefix. */
+struct at_parser_prefix_handler {
+	/** Prefix of the responses, for example "+CEREG" or "OK". */
+	const char *prefix;
+	/** Handler called for every response with the prefix. */
+	at_parser_handler_t handler;
+};
+
+/**
+ * @brief Parser of a stream of AT command responses.
+ *
+ * The members are internal and should not be accessed directly.
+ */
+struct at_parser_stream {
+	struct at_param_list *list;
+	const struct at_parser_prefix_handler *handlers;
+	size_t handler_cnt;
+	char *buf;
+	size_t buf_size;
+	size_t len;
+	bool overflow;
+	void *user_data;
+};
+
+/**
+ * @brief Initialize a parser of a stream of AT command responses.
+ *
+ * The stream is split into lines, and every line into commands separated
+ * with ';'. Lines that start with "AT" (in any case) are echoed commands
+ * and are skipped. Text before ':', '=' or '?' of every command is the
+ * prefix. If a handler is
+ * registered for the prefix, the parameters that follow are parsed to
+ * @p list and the handler is called. Other responses are ignored.
+ *
+ * @param stream      Stream parser to initialize.
+ * @param list        Initialized list where parameters are stored.
+ * @param handlers    Handlers sorted by prefix (in strcmp order).
+ * @param handler_cnt Number of handlers.
+ * @param buf         Buffer for a line that is not yet complete. Longer
+ *                    lines are dropped.
+ * @param buf_size    Size of @p buf.
+ * @param user_data   User data passed to the handlers.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL If a parameter is invalid or handlers are not sorted.
+ */
+int at_parser_stream_init(struct at_parser_stream *stream,
+			  struct at_param_list *list,
+			  const struct at_parser_prefix_handler *handlers,
+			  size_t handler_cnt, char *buf, size_t buf_size,
+			  void *user_data);
+
+/**
+ * @brief Drop a line that is not yet complete.
+ *
+ * @param stream Stream parser.
+ */
+void at_parser_stream_reset(struct at_parser_stream *stream);
+
+/**
+ * @brief Parse data received from the modem.
+ *
+ * The data can contain any number of lines, and can end in the middle of
+ * a line. A line is complete when '\r', '\n' or '\0' is received. Handlers
+ * are called for the complete lines from the context of this function.
+ *
+ * @param stream Stream parser.
+ * @param data   Received data.
+ * @param len    Length of @p data.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOBUFS If a line did not fit in the buffer and was dropped.
+ *         Otherwise, the (negative) error code of the first response that
+ *         could not be parsed is returned. Remaining data is still parsed.
+ */
+int at_parser_stream_feed(struct at_parser_stream *stream,
+			  const char *data, size_t len);
+
 /** @} */
 
 #endif /* AT_CMD_PARSER_H_ */
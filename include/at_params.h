@@ -22,6 +22,10 @@
  * Parameters should be cleared to free that memory. Getter and setter
  * methods are available to read parameter values.
  *
+ * String values are allocated on the heap, unless the list is created with
+ * an arena (see @ref at_params_list_arena_init). Then, string values are
+ * copied to the arena, and the heap is not used after the list is created.
+ *
  */
 
 #include <zephyr/types.h>
@@ -54,6 +58,16 @@ struct at_param {
 	union at_param_value value;
 };
 
+/** Buffer for string values of a parameter list. */
+struct at_params_arena {
+	/** Size of the buffer. */
+	size_t size;
+	/** Number of bytes used by the string values. */
+	size_t used;
+	/** Buffer. */
+	char buf[];
+};
+
 /**
  * @brief List of AT parameters that compose an AT command or response.
  *
@@ -63,6 +77,7 @@ struct at_param {
 struct at_param_list {
 	size_t param_count;
 	struct at_param *params;
+	struct at_params_arena *arena;
 };
 
 /**
@@ -83,6 +98,27 @@ int at_params_list_init(struct at_param_list *list,
 			     size_t max_params_count);
 
 
+/**
+ * @brief Create a list of parameters with an arena for string values.
+ *
+ * Works like @ref at_params_list_init, but additionally allocates an arena
+ * of @p arena_size bytes. String values are copied to the arena instead of
+ * being allocated on the heap. The arena is released when the whole list is
+ * cleared, so a replaced or cleared string parameter does not release its
+ * memory before that. Every string value occupies its length plus one byte.
+ *
+ * @param[in] list Parameter list to initialize.
+ * @param[in] max_params_count Maximum number of element that the list can
+ * store.
+ * @param[in] arena_size Size of the arena for string values (in bytes).
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int at_params_list_arena_init(struct at_param_list *list,
+			      size_t max_params_count, size_t arena_size);
+
+
 /**
  * @brief Clear/reset all parameter types and values.
  *
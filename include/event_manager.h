@@ -54,6 +54,28 @@ extern "C" {
 #define SUBS_PRIO_COUNT (SUBS_PRIO_MAX - SUBS_PRIO_MIN + 1)
 
 
+/** @brief Event delivery class.
+ *
+ * Events of different delivery classes are processed independently.
+ * Events of the same class are processed in the order of submission.
+ */
+enum event_delivery_class {
+	/** Events processed by the system work queue. */
+	EVENT_DELIVERY_DEFAULT,
+
+	/** Latency critical events processed by a dedicated high priority
+	 *  work queue. */
+	EVENT_DELIVERY_REALTIME,
+
+	/** Background events processed by a dedicated low priority
+	 *  work queue. */
+	EVENT_DELIVERY_BULK,
+
+	/** Number of delivery classes. */
+	EVENT_DELIVERY_CLASS_COUNT
+};
+
+
 /** @brief Event header.
  *
  * When defining an event structure, the event header
@@ -65,6 +87,80 @@ struct event_header {
 
 	/** Pointer to the event type object. */
 	const struct event_type *type_id;
+
+#if CONFIG_DESKTOP_EVENT_MANAGER_STATS
+	/** Cycle counter value at the event submission. */
+	u32_t timestamp;
+#endif
+};
+
+
+/** @brief Variable size data of an event.
+ *
+ * When defining an event with variable size data, this structure
+ * must be placed as the last field.
+ */
+struct event_dyndata {
+	/** Number of references to the event. */
+	atomic_t ref_cnt;
+
+	/** Size of the data. */
+	size_t size;
+
+	/** Data. */
+	u8_t data[];
+};
+
+
+/** Number of buckets in the event latency histogram. */
+#define EVENT_MANAGER_STATS_LATENCY_BUCKET_CNT 16
+
+
+/** @brief Event type statistics.
+ *
+ * Latencies are measured in hardware cycles from the event submission
+ * to the start of the event dispatch.
+ */
+struct event_type_stats {
+	/** Number of submitted events. */
+	u32_t submitted;
+
+	/** Number of events merged into a queued event. */
+	u32_t merged;
+
+	/** Number of events dispatched to listeners. */
+	u32_t delivered;
+
+	/** Number of events consumed by a listener. */
+	u32_t consumed;
+
+	/** Highest number of queued events of this type. */
+	u32_t max_queue_depth;
+
+	/** Lowest latency. */
+	u32_t latency_min;
+
+	/** Highest latency. */
+	u32_t latency_max;
+
+	/** Sum of latencies of all delivered events. */
+	u64_t latency_sum;
+
+	/** Latency histogram. Bucket 0 counts latencies of 0 cycles and
+	 *  bucket n counts latencies from 2^(n-1) to 2^n - 1 cycles.
+	 *  The last bucket also counts all longer latencies. */
+	u32_t latency_hist[EVENT_MANAGER_STATS_LATENCY_BUCKET_CNT];
+};
+
+
+/** @brief Event listener statistics.
+ */
+struct event_listener_stats {
+	/** Number of notifications. */
+	u32_t notification_cnt;
+
+	/** Hardware cycles spent in the notification function. */
+	u64_t cycles;
 };
 
 
@@ -79,6 +175,11 @@ struct event_listener {
 	/** Pointer to the function that is called when an event
 	 *  is handled. */
 	bool (*notification)(const struct event_header *eh);
+
+#if CONFIG_DESKTOP_EVENT_MANAGER_STATS
+	/** Listener statistics, one entry per delivery class. */
+	struct event_listener_stats *stats;
+#endif
 };
 
 
@@ -108,12 +209,50 @@ struct event_info {
 };
 
 
+/** @brief Event type runtime state.
+ */
+struct event_type_state {
+	/** Index of the first subscriber in the dispatch table. */
+	u16_t dispatch_start;
+
+	/** Index of the element directly after the last subscriber in
+	 * the dispatch table. */
+	u16_t dispatch_stop;
+
+	/** Queued event that can be coalesced with newly submitted ones.
+	 * Cleared before the event is processed.
+	 */
+	struct event_header *coalesce_pending;
+
+	/** Queue generation in which the pending event was queued. */
+	u32_t coalesce_gen;
+
+	/** Logging of the event type is enabled. */
+	bool log_enabled;
+
+#if CONFIG_DESKTOP_EVENT_MANAGER_STATS
+	/** Number of queued events. */
+	atomic_t queue_depth;
+
+	/** Event type statistics. */
+	struct event_type_stats stats;
+#endif
+};
+
+
 /** @brief Event type.
  */
 struct event_type {
 	/** Event name. */
 	const char			*name;
 
+	/** Size of the event structure. */
+	size_t				size;
+
+	/** Offset of the variable size data in the event structure or zero
+	 * if the event has no variable size data. */
+	size_t				dyndata_offset;
+
 	/** Array of pointers to the array of subscribers. */
 	const struct event_subscriber	*subs_start[SUBS_PRIO_COUNT];
 
@@ -124,12 +263,27 @@ struct event_type {
 	/** Bool indicating if the event is logged by default. */
 	bool init_log_enable;
 
+	/** Delivery class of the event. */
+	enum event_delivery_class delivery_class;
+
+	/** Bool indicating if the event is coalesced with a queued event
+	 * of the same type. */
+	bool coalesce;
+
+	/** Function to merge a newly submitted event into the queued one.
+	 * If NULL, the data of the queued event is replaced. */
+	void (*merge)(struct event_header *queued,
+		      const struct event_header *eh);
+
 	/** Function to log data from this event. */
 	int (*log_event)(const struct event_header *eh, char *buf,
 			      size_t buf_len);
 
 	/** Logging and formatting information. */
 	const struct event_info *ev_info;
+
+	/** Runtime state of the event type. */
+	struct event_type_state *state;
 };
 
 
@@ -148,6 +302,16 @@ extern const struct event_type __stop_event_types[];
 #define EVENT_LISTENER(lname, cb_fn) _EVENT_LISTENER(lname, cb_fn)
 
 
+/** Get a pointer to an event listener object.
+ *
+ * The macro can only be used in the file where the listener
+ * is defined.
+ *
+ * @param lname  Module name.
+ */
+#define EVENT_LISTENER_GET(lname) _EVENT_LISTENER_GET(lname)
+
+
 /** Subscribe a listener to the early notification list for an
  *  event type.
  *
@@ -212,6 +376,52 @@ extern const struct event_type __stop_event_types[];
 #define EVENT_TYPE_DECLARE(ename) _EVENT_TYPE_DECLARE(ename)
 
 
+/** Declare an event type with variable size data.
+ *
+ * The event structure must contain struct event_dyndata named dyndata
+ * as its last field. Size of the data is passed to the allocator function
+ * (new_<i>%event_type</i>) and the data is placed in the same memory
+ * block as the event.
+ *
+ * Listeners can keep such event after the notification using
+ * @ref event_manager_event_ref.
+ *
+ * @param ename  Name of the event.
+ */
+#define EVENT_TYPE_DYNDATA_DECLARE(ename) _EVENT_TYPE_DYNDATA_DECLARE(ename)
+
+
+/** Assign an event type to a delivery class.
+ *
+ * This macro can be passed as an optional argument of
+ * @ref EVENT_TYPE_DEFINE. By default, events use
+ * @ref EVENT_DELIVERY_DEFAULT.
+ *
+ * @param cls  Delivery class (see @ref event_delivery_class).
+ */
+#define EVENT_DELIVERY_CLASS(cls) _EVENT_TYPE_ATTR(delivery_class, cls)
+
+
+/** Enable coalescing for an event type.
+ *
+ * This macro can be passed as an optional argument of
+ * @ref EVENT_TYPE_DEFINE. If an event of this type is submitted while
+ * another event of the same type is still waiting in the queue, the new
+ * event is merged into the queued one and freed. The queued event keeps
+ * its position in the queue.
+ *
+ * The merge function is called with the event queue locked and must not
+ * block. Coalescing cannot be used with the lock-free event queue,
+ * @ref event_manager_init fails if it is.
+ *
+ * @param merge_fn  Function to merge the new event into the queued one
+ *                  or NULL to replace the data of the queued event.
+ */
+#define EVENT_COALESCE(merge_fn)			\
+	_EVENT_TYPE_ATTR(coalesce, true),		\
+	_EVENT_TYPE_ATTR(merge, merge_fn)
+
+
 /** Define an event type.
  *
  * This macro defines an event type. In addition, it defines functions
@@ -231,9 +441,12 @@ extern const struct event_type __stop_event_types[];
  *                         by default.
  * @param log_fn  	   Function to stringify an event of this type.
  * @param ev_info_struct   Data structure describing the event type.
+ * @param ...              Optional event type attributes, for example
+ *                         @ref EVENT_DELIVERY_CLASS or
+ *                         @ref EVENT_COALESCE.
  */
-#define EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct) \
-	_EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct)
+#define EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct, ...) \
+	_EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct, __VA_ARGS__)
 
 
 /** Verify if an event ID is valid.
@@ -248,6 +461,105 @@ extern const struct event_type __stop_event_types[];
 	__ASSERT_NO_MSG((id >= __start_event_types) && (id < __stop_event_types))
 
 
+/** Allocate memory for an event.
+ *
+ * Depending on the configuration, the memory is taken either from the
+ * heap or from one of the fixed-size event pools.
+ *
+ * @param size  Number of bytes to allocate.
+ *
+ * @return Pointer to the allocated memory or NULL if there is no
+ *         memory available.
+ */
+void *event_manager_alloc(size_t size);
+
+
+/** Free memory of an event.
+ *
+ * @param addr  Pointer to the memory previously allocated with
+ *              @ref event_manager_alloc.
+ */
+void event_manager_free(void *addr);
+
+
+/** @brief Event pool statistics.
+ */
+struct event_manager_pool_stats {
+	/** Size of a single block in the pool. */
+	size_t block_size;
+
+	/** Number of blocks in the pool. */
+	u32_t block_cnt;
+
+	/** Number of blocks currently in use. */
+	u32_t used;
+
+	/** Highest number of blocks in use at the same time. */
+	u32_t max_used;
+
+	/** Number of allocations that did not fit in the pool because it
+	 *  was exhausted. */
+	u32_t exhausted_cnt;
+};
+
+
+/** Get statistics of an event pool.
+ *
+ * @param pool_idx  Index of the pool.
+ * @param stats     Pointer to the structure that is filled with statistics.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOENT If there is no pool with the given index.
+ * @retval -ENOTSUP If events are not allocated from pools.
+ */
+int event_manager_pool_stats_get(size_t pool_idx,
+				 struct event_manager_pool_stats *stats);
+
+
+/** Enable or disable notifications of an event listener.
+ *
+ * A disabled listener is skipped when events are dispatched.
+ * Listeners are enabled by default.
+ *
+ * @param el      Pointer to the listener.
+ * @param enable  True to enable the listener, false to disable it.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOTSUP If the dispatch table is not used.
+ */
+int event_manager_listener_enable(const struct event_listener *el,
+				  bool enable);
+
+
+/** Check if an event listener is enabled.
+ *
+ * @param el  Pointer to the listener.
+ *
+ * @return True if the listener is notified about events.
+ */
+bool event_manager_listener_is_enabled(const struct event_listener *el);
+
+
+/** Enable or disable logging of an event type.
+ *
+ * Logging is initially enabled for event types defined with
+ * the init_log_en flag set.
+ *
+ * @param et      Pointer to the event type.
+ * @param enable  True to enable logging, false to disable it.
+ */
+void event_manager_event_log_enable(const struct event_type *et, bool enable);
+
+
+/** Check if logging of an event type is enabled.
+ *
+ * @param et  Pointer to the event type.
+ *
+ * @return True if events of the given type are logged.
+ */
+bool event_manager_event_log_is_enabled(const struct event_type *et);
+
+
 /** Submit an event to the Event Manager.
  *
  * @param eh  Pointer to the event header element in the event object.
@@ -264,6 +576,83 @@ void _event_submit(struct event_header *eh);
 #define EVENT_SUBMIT(event) _event_submit(&event->header)
 
 
+/** Add an event to a batch.
+ *
+ * The batch is a list initialized with sys_dlist_init.
+ * Events in the batch are submitted with @ref event_submit_batch.
+ *
+ * @param batch  Pointer to the batch.
+ * @param event  Pointer to the event object.
+ */
+#define EVENT_BATCH_ADD(batch, event) \
+	sys_dlist_append((batch), &(event)->header.node)
+
+
+/** Submit a batch of events.
+ *
+ * All events from the batch are appended to the processing queue under
+ * a single lock acquisition and processing is scheduled once. Events are
+ * processed in the order in which they were added to the batch.
+ * The batch is empty when the function returns.
+ *
+ * @param batch  Pointer to the batch.
+ */
+void event_submit_batch(sys_dlist_t *batch);
+
+
+/** Take a reference to an event with variable size data.
+ *
+ * The event is not freed after the processing until all references
+ * are released with @ref event_manager_event_unref. The event data
+ * must not be modified after the event is submitted.
+ *
+ * @param eh  Pointer to the event header.
+ */
+void event_manager_event_ref(const struct event_header *eh);
+
+
+/** Release a reference to an event with variable size data.
+ *
+ * The event is freed when the last reference is released.
+ *
+ * @param eh  Pointer to the event header.
+ */
+void event_manager_event_unref(const struct event_header *eh);
+
+
+/** Get statistics of an event type.
+ *
+ * @param et     Pointer to the event type object.
+ * @param stats  Pointer to the structure to be filled.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOTSUP If statistics are not enabled.
+ */
+int event_manager_type_stats_get(const struct event_type *et,
+				 struct event_type_stats *stats);
+
+
+/** Get statistics of an event listener.
+ *
+ * @param el     Pointer to the event listener object.
+ * @param stats  Pointer to the structure to be filled.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOTSUP If statistics are not enabled.
+ */
+int event_manager_listener_stats_get(const struct event_listener *el,
+				     struct event_listener_stats *stats);
+
+
+/** Reset statistics of all event types and listeners.
+ *
+ * Statistics of a delivery class are reset right away when called from the
+ * work queue of the class. Otherwise, they are reset by that work queue
+ * after the work already submitted to it.
+ */
+void event_manager_stats_reset(void);
+
+
 /** Initialize the Event Manager.
  *
  * @retval 0 If the operation was successful.
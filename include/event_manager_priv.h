@@ -78,6 +78,10 @@ extern "C" {
 	}
 
 
+/* Pointer to event listener object. */
+#define _EVENT_LISTENER_GET(lname) (&_CONCAT(__event_listener_, lname))
+
+
 /* Pointer to event type definition is used as event type identifier. */
 #define _EVENT_ID(ename) (&_CONCAT(__event_type_, ename))
 
@@ -89,7 +93,7 @@ extern "C" {
 #define _EVENT_ALLOCATOR_FN(ename)					\
 	static inline struct ename *_CONCAT(new_, ename)(void)		\
 	{								\
-		struct ename *event = k_malloc(sizeof(*event));		\
+		struct ename *event = event_manager_alloc(sizeof(*event));	\
 		if (unlikely(!event)) {					\
 			printk("Event Manager OOM error\n");		\
 			LOG_PANIC();					\
@@ -101,6 +105,37 @@ extern "C" {
 	}
 
 
+/* Macro generates a function of name new_ename where ename is provided as
+ * an argument. Allocator function is used to create an event of the given
+ * ename type with variable size data of the given size.
+ */
+#define _EVENT_ALLOCATOR_DYNDATA_FN(ename)					\
+	static inline struct ename *_CONCAT(new_, ename)(size_t size)		\
+	{									\
+		struct ename *event =						\
+			event_manager_alloc(sizeof(*event) + size);		\
+		if (unlikely(!event)) {						\
+			printk("Event Manager OOM error\n");			\
+			LOG_PANIC();						\
+			sys_reboot(SYS_REBOOT_WARM);				\
+			return NULL;						\
+		}								\
+		event->header.type_id = _EVENT_ID(ename);			\
+		event->dyndata.size = size;					\
+		atomic_set(&event->dyndata.ref_cnt, 1);				\
+		return event;							\
+	}
+
+
+/* Offset of variable size data within an event. Zero is used for events
+ * without variable size data.
+ */
+#define _EVENT_DYNDATA_OFFSET(ename) _CONCAT(__event_dyndata_offset_, ename)
+
+#define _EVENT_DYNDATA_OFFSET_DECLARE(ename, offset)			\
+	enum { _EVENT_DYNDATA_OFFSET(ename) = (offset) }
+
+
 /* Macro generates a function of name cast_ename where ename is provided as
  * an argument. Casting function is used to convert event_header pointer
  * into pointer to event matching the given ename type.
@@ -154,6 +189,10 @@ extern "C" {
 #endif /* CONFIG_DESKTOP_EVENT_MANAGER_PROFILE_EVENT_DATA */
 
 
+/* Optional attribute of an event type. */
+#define _EVENT_TYPE_ATTR(field, value) .field = (value)
+
+
 /* Declarations and definitions - for more details refer to public API. */
 #define _EVENT_INFO_DEFINE(ename, types, labels, profile_func)							\
 	const static char *_CONCAT(ename, _log_arg_labels[]) __used = _ARG_LABELS_DEFINE(labels);		\
@@ -167,27 +206,57 @@ extern "C" {
 			}
 
 
+#if CONFIG_DESKTOP_EVENT_MANAGER_STATS
+#define _EVENT_LISTENER_STATS_DEFINE(lname)					\
+	static struct event_listener_stats					\
+		_CONCAT(__event_listener_stats_, lname)[EVENT_DELIVERY_CLASS_COUNT];
+
+#define _EVENT_LISTENER_STATS_ATTR(lname)					\
+	.stats = _CONCAT(__event_listener_stats_, lname),
+#else
+#define _EVENT_LISTENER_STATS_DEFINE(lname)
+#define _EVENT_LISTENER_STATS_ATTR(lname)
+#endif
+
+
 #define _EVENT_LISTENER(lname, notification_fn)					\
+	_EVENT_LISTENER_STATS_DEFINE(lname)					\
 	const struct event_listener _CONCAT(__event_listener_, lname) __used	\
 	__attribute__((__section__("event_listeners"))) = {			\
 		.name = STRINGIFY(lname),					\
 		.notification = (notification_fn),				\
+		_EVENT_LISTENER_STATS_ATTR(lname)				\
 	}
 
 
 #define _EVENT_TYPE_DECLARE(ename)					\
 	extern const struct event_type _CONCAT(__event_type_, ename);	\
 	_EVENT_SUBSCRIBERS_DECLARE(ename);				\
+	_EVENT_DYNDATA_OFFSET_DECLARE(ename, 0);			\
 	_EVENT_ALLOCATOR_FN(ename);					\
 	_EVENT_CASTER_FN(ename);					\
 	_EVENT_TYPECHECK_FN(ename)
 
 
-#define _EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct)							\
+#define _EVENT_TYPE_DYNDATA_DECLARE(ename)					\
+	extern const struct event_type _CONCAT(__event_type_, ename);		\
+	_EVENT_SUBSCRIBERS_DECLARE(ename);					\
+	_EVENT_DYNDATA_OFFSET_DECLARE(ename, offsetof(struct ename, dyndata));	\
+	_EVENT_ALLOCATOR_DYNDATA_FN(ename);					\
+	_EVENT_CASTER_FN(ename);						\
+	_EVENT_TYPECHECK_FN(ename)
+
+
+#define _EVENT_TYPE_DEFINE(ename, init_log_en, log_fn, ev_info_struct, ...)						\
 	_EVENT_SUBSCRIBERS_DEFINE(ename);										\
+	static struct event_type_state _CONCAT(__event_type_state_, ename) = {						\
+		.log_enabled			= init_log_en,								\
+	};														\
 	const struct event_type _CONCAT(__event_type_, ename) __used							\
 	__attribute__((__section__("event_types"))) = {									\
 		.name				= STRINGIFY(ename),							\
+		.size				= sizeof(struct ename),							\
+		.dyndata_offset			= _EVENT_DYNDATA_OFFSET(ename),						\
 		.subs_start	= {											\
 			[_SUBS_PRIO_FIRST]	= _EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_ID(_SUBS_PRIO_FIRST)),	\
 			[_SUBS_PRIO_NORMAL]	= _EVENT_SUBSCRIBERS_START(ename, _SUBS_PRIO_ID(_SUBS_PRIO_NORMAL)),	\
@@ -201,6 +270,8 @@ extern "C" {
 		.init_log_enable		= init_log_en,								\
 		.log_event			= log_fn,								\
 		.ev_info			= ev_info_struct,							\
+		.state				= &_CONCAT(__event_type_state_, ename),					\
+		__VA_ARGS__												\
 	}
 
 
@@ -12,13 +12,109 @@
 #ifndef ZEPHYR_INCLUDE_LTE_LINK_CONTROL_H_
 #define ZEPHYR_INCLUDE_LTE_LINK_CONTROL_H_
 
-/** @brief Function for initializing
- * and make a connection with the modem
+#include <zephyr/types.h>
+#include <stdbool.h>
+
+/** @brief Network registration status, <stat> of +CEREG.
+ * For reference see 3GPP 27.007 Ch. 10.1.22.
+ */
+enum lte_lc_nw_reg_status {
+	LTE_LC_NW_REG_NOT_REGISTERED		= 0,
+	LTE_LC_NW_REG_REGISTERED_HOME		= 1,
+	LTE_LC_NW_REG_SEARCHING			= 2,
+	LTE_LC_NW_REG_REGISTRATION_DENIED	= 3,
+	LTE_LC_NW_REG_UNKNOWN			= 4,
+	LTE_LC_NW_REG_REGISTERED_ROAMING	= 5,
+	LTE_LC_NW_REG_REGISTERED_EMERGENCY	= 8,
+	LTE_LC_NW_REG_UICC_FAIL			= 90,
+};
+
+/** @brief Access technology, <AcT> of +CEREG. */
+enum lte_lc_lte_mode {
+	LTE_LC_LTE_MODE_NONE	= 0,
+	LTE_LC_LTE_MODE_LTEM	= 7,
+	LTE_LC_LTE_MODE_NBIOT	= 9,
+};
+
+/** @brief Network registration information reported by +CEREG. */
+struct lte_lc_nw_reg_info {
+	/** Registration status. */
+	enum lte_lc_nw_reg_status status;
+	/** Tracking area code, zero if not reported. */
+	u32_t tac;
+	/** E-UTRAN cell ID, zero if not reported. */
+	u32_t cell_id;
+	/** Access technology of the serving cell. */
+	enum lte_lc_lte_mode mode;
+};
+
+/** @brief Type of LTE link control event. */
+enum lte_lc_evt_type {
+	/** Registration status, cell or access technology changed. */
+	LTE_LC_EVT_NW_REG_STATUS,
+	/** Connecting finished, the modem is registered to a network. */
+	LTE_LC_EVT_CONNECTED,
+	/** Connecting failed or timed out, see the error code. */
+	LTE_LC_EVT_CONNECT_FAILED,
+};
+
+/** @brief LTE link control event. */
+struct lte_lc_evt {
+	enum lte_lc_evt_type type;
+	/** Network registration information at the time of the event. */
+	struct lte_lc_nw_reg_info nw_reg;
+	/** Error code of LTE_LC_EVT_CONNECT_FAILED, -ETIMEDOUT if no network
+	 *  was found in time.
+	 */
+	int err;
+};
+
+/** @brief Handler of LTE link control events.
+ *
+ * The handler is called from the thread of the AT command service or from
+ * the system work queue. It must not wait for AT commands to complete.
+ */
+typedef void (*lte_lc_evt_handler_t)(const struct lte_lc_evt *evt);
+
+/** @brief Function for setting the handler of LTE link control events.
+ *
+ * @param handler Event handler, NULL to remove the handler.
+ */
+void lte_lc_register_handler(lte_lc_evt_handler_t handler);
+
+/** @brief Function for initializing and making a connection with the modem.
+ *
+ * Blocks until the modem is registered to a network or
+ * CONFIG_LTE_NETWORK_TIMEOUT expires.
  *
  * @return Zero on success or (negative) error code otherwise.
  */
 int lte_lc_init_and_connect(void);
 
+/** @brief Function for initializing and making a connection with the modem
+ * without blocking.
+ *
+ * The modem is configured and activated in the background. The result is
+ * reported to the registered handler by LTE_LC_EVT_CONNECTED or
+ * LTE_LC_EVT_CONNECT_FAILED.
+ *
+ * @param timeout Time to wait for registration in milliseconds,
+ *                or K_FOREVER.
+ *
+ * @return Zero if connecting was started, -EINPROGRESS if it is already
+ *         in progress or (negative) error code otherwise.
+ */
+int lte_lc_init_and_connect_async(s32_t timeout);
+
+/** @brief Function for reading the last reported network registration
+ * information.
+ *
+ * @param info Buffer for the information.
+ *
+ * @return Zero on success or (negative) error code otherwise.
+ */
+int lte_lc_nw_reg_info_get(struct lte_lc_nw_reg_info *info);
+
 /** @brief Function for sending the modem to offline mode
  *
  * @return Zero on success or (negative) error code otherwise.
@@ -16,20 +16,31 @@
 
 
 #include <zephyr/types.h>
+#include <atomic.h>
+#include <errno.h>
 
 #ifndef CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS
 /** Maximum number of custom events. */
 #define CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS 0
 #endif
 
-/** @brief Set of flags for enabling/disabling profiling for given event types.
+/** @brief Bitmap of flags for enabling/disabling profiling for given event
+ *  types.
  */
-extern u32_t profiler_enabled_events;
+extern atomic_t profiler_enabled_events[];
 
 
-/** @brief Number of event types registered in the Profiler.
+/** @brief Number of event type IDs assigned by the Profiler.
+ *
+ * An event type becomes visible shortly after its ID is assigned. Use
+ * @ref profiler_get_event_name to check if the event type is registered.
  */
-extern u8_t profiler_num_events;
+extern atomic_t profiler_num_events;
+
+
+/** @brief Event type ID returned when an event type cannot be registered.
+ */
+#define PROFILER_INVALID_EVENT_TYPE_ID UINT16_MAX
 
 
 /** @brief Data types for profiling.
@@ -77,16 +88,16 @@ void profiler_term(void);
 static inline void profiler_term(void) {}
 #endif
 
-/** @brief Retrieve the description of an event type.
+/** @brief Retrieve the name of an event type.
  *
  * @param profiler_event_id Event ID.
  *
- * @return Event description.
+ * @return Event name or NULL if the event type is not registered.
  */
 #ifdef CONFIG_PROFILER
-const char *profiler_get_event_descr(size_t profiler_event_id);
+const char *profiler_get_event_name(size_t profiler_event_id);
 #else
-static inline const char *profiler_get_event_descr(size_t profiler_event_id)
+static inline const char *profiler_get_event_name(size_t profiler_event_id)
 {
 	return NULL;
 }
@@ -100,24 +111,30 @@ static inline const char *profiler_get_event_descr(size_t profiler_event_id)
  */
 static inline bool is_profiling_enabled(size_t profiler_event_id)
 {
-	if (IS_ENABLED(CONFIG_PROFILER)) {
-		__ASSERT_NO_MSG(profiler_event_id < CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS);
-		return (profiler_enabled_events & BIT(profiler_event_id)) != 0;
+	if (IS_ENABLED(CONFIG_PROFILER) &&
+	    (profiler_event_id < CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS)) {
+		return atomic_test_bit(profiler_enabled_events,
+				       profiler_event_id);
 	}
 	return false;
 }
 
 /** @brief Register an event type.
  *
- * @warning This function is thread-safe, but not safe to use in
- * interrupts.
+ * The function can be called at any time from any context, when using
+ * the Nordic profiler.
+ *
+ * @warning The name and the arrays are not copied. They must stay valid
+ * for the lifetime of the Profiler.
  *
  * @param name Name of the event type.
  * @param args Names of data values sent with the event.
  * @param arg_types Types of data values sent with the event.
  * @param arg_cnt Number of data values sent with the event.
  *
- * @return ID assigned to the event type.
+ * @return ID assigned to the event type or
+ *	   @ref PROFILER_INVALID_EVENT_TYPE_ID if too many event types are
+ *	   registered.
  */
 #ifdef CONFIG_PROFILER
 u16_t profiler_register_event_type(const char *name, const char **args,
@@ -194,6 +211,154 @@ static inline void profiler_log_send(struct log_event_buf *buf,
 #endif
 
 
+/** @brief Span type ID returned when a span type cannot be registered.
+ */
+#define PROFILER_INVALID_SPAN_ID UINT16_MAX
+
+
+/** @brief Statistics of a span type.
+ *
+ * Durations are given in microseconds.
+ */
+struct profiler_span_stats {
+	/** Number of finished spans. */
+	u32_t count;
+	/** Minimum duration. */
+	u32_t min;
+	/** Maximum duration. */
+	u32_t max;
+	/** Mean duration. */
+	u32_t mean;
+};
+
+
+/** @brief Register a span type.
+ *
+ * A span is the time between @ref profiler_span_begin and
+ * @ref profiler_span_end. Every span type is profiled as an event type with
+ * the given name, logged at the beginning and at the end of the span.
+ *
+ * @warning The name is not copied. It must stay valid for the lifetime of
+ * the Profiler.
+ *
+ * @param name Name of the span type.
+ *
+ * @return ID assigned to the span type or @ref PROFILER_INVALID_SPAN_ID if
+ *	   too many span types are registered.
+ */
+#ifdef CONFIG_PROFILER_SPAN
+u16_t profiler_span_register(const char *name);
+#else
+static inline u16_t profiler_span_register(const char *name) {return 0; }
+#endif
+
+
+/** @brief Begin a span.
+ *
+ * Spans can be nested. Every thread has a separate stack of open spans.
+ *
+ * @warning This function must not be called from interrupts.
+ *
+ * @param span_id Span type ID as assigned when the span type is registered.
+ */
+#ifdef CONFIG_PROFILER_SPAN
+void profiler_span_begin(u16_t span_id);
+#else
+static inline void profiler_span_begin(u16_t span_id) {}
+#endif
+
+
+/** @brief End a span.
+ *
+ * The span must be the last span begun by the thread that is not ended yet.
+ *
+ * @param span_id Span type ID as assigned when the span type is registered.
+ */
+#ifdef CONFIG_PROFILER_SPAN
+void profiler_span_end(u16_t span_id);
+#else
+static inline void profiler_span_end(u16_t span_id) {}
+#endif
+
+
+/** @brief Get statistics of a span type.
+ *
+ * @param span_id Span type ID.
+ * @param stats Pointer to the structure filled with the statistics.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOENT If the span type is not registered.
+ * @retval -ENOTSUP If the statistics are disabled.
+ */
+#ifdef CONFIG_PROFILER_SPAN_STATS
+int profiler_span_stats_get(u16_t span_id, struct profiler_span_stats *stats);
+#else
+static inline int profiler_span_stats_get(u16_t span_id,
+					  struct profiler_span_stats *stats)
+{
+	return -ENOTSUP;
+}
+#endif
+
+
+/** @brief Reset statistics of all span types.
+ */
+#ifdef CONFIG_PROFILER_SPAN_STATS
+void profiler_span_stats_reset(void);
+#else
+static inline void profiler_span_stats_reset(void) {}
+#endif
+
+
+/** @brief Get the name of a span type.
+ *
+ * @param span_id Span type ID.
+ *
+ * @return Span name or NULL if the span type is not registered.
+ */
+#ifdef CONFIG_PROFILER_SPAN
+const char *profiler_span_name_get(u16_t span_id);
+#else
+static inline const char *profiler_span_name_get(u16_t span_id)
+{
+	return NULL;
+}
+#endif
+
+
+/** @brief Start sampling the interrupted code and thread.
+ *
+ * Samples are taken every @option{CONFIG_PROFILER_NORDIC_SAMPLING_PERIOD}
+ * milliseconds and collected in a histogram that is periodically sent to
+ * the host.
+ */
+#ifdef CONFIG_PROFILER_NORDIC_SAMPLING
+void profiler_sampling_start(void);
+#else
+static inline void profiler_sampling_start(void) {}
+#endif
+
+
+/** @brief Stop sampling.
+ */
+#ifdef CONFIG_PROFILER_NORDIC_SAMPLING
+void profiler_sampling_stop(void);
+#else
+static inline void profiler_sampling_stop(void) {}
+#endif
+
+
+/** @brief Request sending the sampling histogram to the host.
+ *
+ * The histogram is sent by the Profiler thread and cleared.
+ */
+#ifdef CONFIG_PROFILER_NORDIC_SAMPLING
+void profiler_sampling_dump(void);
+#else
+static inline void profiler_sampling_dump(void) {}
+#endif
+
+
 /**
  * @}
  */
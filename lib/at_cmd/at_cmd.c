@@ -0,0 +1,625 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <zephyr/types.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <init.h>
+#include <net/socket.h>
+#include <at_cmd.h>
+#include <at_cmd_parser.h>
+#include <logging/log.h>
+
+LOG_MODULE_REGISTER(at_cmd, CONFIG_AT_CMD_LOG_LEVEL);
+
+#define INVALID_DESCRIPTOR	-1
+#define THREAD_PRIORITY		K_PRIO_PREEMPT(CONFIG_AT_CMD_THREAD_PRIO)
+
+static const char ok_str[] = "OK";
+static const char error_str[] = "ERROR";
+static const char cme_error_str[] = "+CME ERROR:";
+static const char cms_error_str[] = "+CMS ERROR:";
+
+static int at_socket_fd = INVALID_DESCRIPTOR;
+static struct pollfd fds;
+
+/* Queued requests. Command of the first request is sent to the modem if
+ * req_sent is set.
+ */
+static sys_slist_t req_queue;
+static bool req_sent;
+/* Command failed without the final result code, which is still expected.
+ * Next command is not sent until the response is discarded.
+ */
+static bool req_abandoned;
+static struct k_mutex req_lock;
+/* Uptime at which the sent command times out. */
+static s64_t req_deadline;
+static struct k_delayed_work req_timeout_work;
+
+/* Null terminated data read from the AT socket. */
+static char recv_buf[CONFIG_AT_CMD_RECV_BUF_SIZE + 1];
+
+static sys_slist_t urc_subscribers;
+static struct at_parser_prefix_handler urc_handlers[CONFIG_AT_CMD_URC_PREFIX_MAX];
+static size_t urc_handler_cnt;
+static struct at_param_list urc_param_list;
+static struct at_parser_stream urc_stream;
+static char urc_line_buf[CONFIG_AT_CMD_RECV_BUF_SIZE];
+static struct k_mutex urc_lock;
+static at_cmd_monitor_t urc_monitor;
+
+static struct k_thread at_cmd_thread;
+static K_THREAD_STACK_DEFINE(at_cmd_thread_stack,
+			     CONFIG_AT_CMD_THREAD_STACK_SIZE);
+
+
+static void reqs_complete(sys_slist_t *done)
+{
+	sys_snode_t *node;
+
+	while ((node = sys_slist_get(done)) != NULL) {
+		struct at_cmd_request *req =
+			CONTAINER_OF(node, struct at_cmd_request, node);
+
+		/* Request can be submitted again from the callback. */
+		int result = req->result;
+		struct k_poll_signal *signal = req->signal;
+
+		if (req->done) {
+			req->done(req);
+		}
+
+		if (signal) {
+			k_poll_signal_raise(signal, result);
+		}
+	}
+}
+
+/* Internal function. Request lock must be held. Sends command of the first
+ * queued request. Requests that cannot be sent are moved to the done list.
+ */
+static void req_send_next(sys_slist_t *done)
+{
+	while (!req_sent && !req_abandoned &&
+	       !sys_slist_is_empty(&req_queue)) {
+		struct at_cmd_request *req =
+			CONTAINER_OF(sys_slist_peek_head(&req_queue),
+				     struct at_cmd_request, node);
+		size_t len = strlen(req->cmd);
+		int bytes;
+
+		LOG_DBG("send: %s", log_strdup(req->cmd));
+		bytes = send(at_socket_fd, req->cmd, len, 0);
+		if (bytes == len) {
+			req_sent = true;
+			req_deadline = k_uptime_get() +
+				K_SECONDS(CONFIG_AT_CMD_RESPONSE_TIMEOUT);
+			k_delayed_work_submit(&req_timeout_work,
+				K_SECONDS(CONFIG_AT_CMD_RESPONSE_TIMEOUT));
+			break;
+		}
+
+		LOG_ERR("send: failed (%d)", bytes);
+		(void)sys_slist_get_not_empty(&req_queue);
+		req->state = AT_CMD_ERROR;
+		req->result = -EIO;
+		sys_slist_append(done, &req->node);
+	}
+}
+
+/* Internal function. Request lock must be held. Waits for the final result
+ * code of an abandoned command, for at most the response timeout.
+ */
+static void req_abandon_wait(void)
+{
+	req_deadline = k_uptime_get() +
+		K_SECONDS(CONFIG_AT_CMD_RESPONSE_TIMEOUT);
+	k_delayed_work_submit(&req_timeout_work,
+			      K_SECONDS(CONFIG_AT_CMD_RESPONSE_TIMEOUT));
+}
+
+/* Internal function. Request lock must be held and a command must be sent.
+ * Moves the first queued request to the done list and sends the next one,
+ * unless the response of the command is still expected.
+ */
+static struct at_cmd_request *req_sent_complete(sys_slist_t *done,
+						 int result)
+{
+	struct at_cmd_request *req =
+		CONTAINER_OF(sys_slist_get_not_empty(&req_queue),
+			     struct at_cmd_request, node);
+
+	req_sent = false;
+	(void)k_delayed_work_cancel(&req_timeout_work);
+	req->result = result;
+	sys_slist_append(done, &req->node);
+
+	/* Next command is sent before the completion callbacks are called,
+	 * so the modem does not wait for the callers.
+	 */
+	req_send_next(done);
+
+	return req;
+}
+
+/* Internal function. Completes the sent command with an error, without
+ * a final result code from the modem. Returns true if the data read from
+ * the socket belongs to a failed command.
+ */
+static bool req_sent_fail(int result)
+{
+	sys_slist_t done;
+
+	sys_slist_init(&done);
+
+	k_mutex_lock(&req_lock, K_FOREVER);
+
+	/* Work may run late, after the command was completed or the next
+	 * command was sent.
+	 */
+	if ((result == -ETIMEDOUT) && (k_uptime_get() < req_deadline)) {
+		k_mutex_unlock(&req_lock);
+		return false;
+	}
+
+	if (req_abandoned) {
+		if (result == -ETIMEDOUT) {
+			LOG_WRN("No final result code of failed command");
+			req_abandoned = false;
+			req_send_next(&done);
+		}
+
+		k_mutex_unlock(&req_lock);
+
+		reqs_complete(&done);
+
+		return true;
+	}
+
+	if (!req_sent) {
+		k_mutex_unlock(&req_lock);
+		return false;
+	}
+
+	/* Set before the completion, so the next command is not sent. */
+	req_abandoned = true;
+
+	struct at_cmd_request *req = req_sent_complete(&done, result);
+
+	req_abandon_wait();
+	req->state = AT_CMD_ERROR;
+	LOG_ERR("%s failed (%d)", log_strdup(req->cmd), result);
+
+	k_mutex_unlock(&req_lock);
+
+	reqs_complete(&done);
+
+	return true;
+}
+
+static void req_timeout_fn(struct k_work *work)
+{
+	ARG_UNUSED(work);
+
+	(void)req_sent_fail(-ETIMEDOUT);
+}
+
+/* Internal function. Parameters cannot be null. Buffer must be null
+ * terminated. Checks if the last line of the buffer is a final result code.
+ */
+static bool final_result_get(const char *buf, size_t len,
+			     enum at_cmd_state *state, int *error_code)
+{
+	while ((len > 0) && ((buf[len - 1] == '\r') || (buf[len - 1] == '\n'))) {
+		len--;
+	}
+
+	size_t start = len;
+
+	while ((start > 0) && (buf[start - 1] != '\r') &&
+	       (buf[start - 1] != '\n')) {
+		start--;
+	}
+
+	const char *line = &buf[start];
+	size_t line_len = len - start;
+
+	*error_code = 0;
+
+	if ((line_len == strlen(ok_str)) &&
+	    !memcmp(line, ok_str, line_len)) {
+		*state = AT_CMD_OK;
+	} else if ((line_len == strlen(error_str)) &&
+		   !memcmp(line, error_str, line_len)) {
+		*state = AT_CMD_ERROR;
+	} else if (!strncmp(line, cme_error_str, strlen(cme_error_str))) {
+		*state = AT_CMD_ERROR_CME;
+		*error_code = strtol(line + strlen(cme_error_str), NULL, 10);
+	} else if (!strncmp(line, cms_error_str, strlen(cms_error_str))) {
+		*state = AT_CMD_ERROR_CMS;
+		*error_code = strtol(line + strlen(cms_error_str), NULL, 10);
+	} else {
+		return false;
+	}
+
+	return true;
+}
+
+static void response_handle(const char *buf, size_t len,
+			    enum at_cmd_state state, int error_code)
+{
+	sys_slist_t done;
+
+	sys_slist_init(&done);
+
+	k_mutex_lock(&req_lock, K_FOREVER);
+
+	if (req_abandoned) {
+		/* Response of a failed command must not complete the next
+		 * one.
+		 */
+		LOG_DBG("Response of failed command discarded");
+		req_abandoned = false;
+		(void)k_delayed_work_cancel(&req_timeout_work);
+		req_send_next(&done);
+		k_mutex_unlock(&req_lock);
+		reqs_complete(&done);
+		return;
+	}
+
+	if (!req_sent) {
+		k_mutex_unlock(&req_lock);
+		LOG_WRN("Response without command: %s", log_strdup(buf));
+		return;
+	}
+
+	struct at_cmd_request *req = req_sent_complete(&done,
+			(state == AT_CMD_OK) ? 0 : -EIO);
+
+	req->state = state;
+	req->error_code = error_code;
+
+	if ((req->resp != NULL) && (req->resp_size > 0)) {
+		req->resp_len = MIN(len, req->resp_size - 1);
+		memcpy(req->resp, buf, req->resp_len);
+		req->resp[req->resp_len] = '\0';
+
+		if ((req->resp_len < len) && (req->result == 0)) {
+			req->result = -ENOBUFS;
+		}
+	}
+
+	k_mutex_unlock(&req_lock);
+
+	reqs_complete(&done);
+}
+
+static void urc_dispatch(const char *prefix, struct at_param_list *list,
+			 void *user_data)
+{
+	struct at_cmd_urc_subscriber *sub;
+
+	ARG_UNUSED(user_data);
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&urc_subscribers, sub, node) {
+		if (!strcmp(sub->prefix, prefix)) {
+			sub->handler(prefix, list, sub->user_data);
+		}
+	}
+}
+
+static void notification_handle(const char *buf, size_t len)
+{
+	LOG_DBG("URC: %s", log_strdup(buf));
+
+	k_mutex_lock(&urc_lock, K_FOREVER);
+
+	if (urc_monitor) {
+		urc_monitor(buf, len);
+	}
+
+	/* Terminating null is passed to the parser to end the last line. */
+	int err = at_parser_stream_feed(&urc_stream, buf, len + 1);
+
+	k_mutex_unlock(&urc_lock);
+
+	if (err) {
+		LOG_WRN("URC not parsed (err: %d)", err);
+	}
+}
+
+static void at_cmd_thread_fn(void *arg1, void *arg2, void *arg3)
+{
+	enum at_cmd_state state;
+	int error_code;
+	int err;
+	int r_bytes;
+
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	while (true) {
+		err = poll(&fds, 1, K_FOREVER);
+		if (err < 0) {
+			LOG_ERR("Poll error: %d", err);
+			continue;
+		}
+
+		/* Commands are not sent while the socket is read. */
+		k_mutex_lock(&req_lock, K_FOREVER);
+		r_bytes = recv(at_socket_fd, recv_buf,
+			       CONFIG_AT_CMD_RECV_BUF_SIZE, MSG_DONTWAIT);
+		k_mutex_unlock(&req_lock);
+
+		/* If no data, errno is set to EAGAIN and we will try again. */
+		if (r_bytes <= 0) {
+			continue;
+		}
+
+		recv_buf[r_bytes] = '\0';
+
+		/* Every read returns either a complete response with the
+		 * final result code or notifications.
+		 */
+		if (final_result_get(recv_buf, r_bytes, &state, &error_code)) {
+			response_handle(recv_buf, r_bytes, state, error_code);
+		} else if ((r_bytes < CONFIG_AT_CMD_RECV_BUF_SIZE) ||
+			   !req_sent_fail(-ENOBUFS)) {
+			/* Full buffer is taken as a response that did not
+			 * fit, if a command was sent, or as a part of it.
+			 */
+			notification_handle(recv_buf, r_bytes);
+		}
+	}
+}
+
+int at_cmd_submit(struct at_cmd_request *req)
+{
+	if ((req == NULL) || (req->cmd == NULL)) {
+		return -EINVAL;
+	}
+
+	if (at_socket_fd == INVALID_DESCRIPTOR) {
+		return -ENOTCONN;
+	}
+
+	req->resp_len = 0;
+	req->state = AT_CMD_OK;
+	req->error_code = 0;
+	req->result = 0;
+
+	k_mutex_lock(&req_lock, K_FOREVER);
+
+	bool idle = sys_slist_is_empty(&req_queue);
+
+	sys_slist_append(&req_queue, &req->node);
+
+	if (idle) {
+		sys_slist_t failed;
+
+		sys_slist_init(&failed);
+		req_send_next(&failed);
+
+		if (!sys_slist_is_empty(&failed)) {
+			/* Only this request could be sent. */
+			k_mutex_unlock(&req_lock);
+			return -EIO;
+		}
+	}
+
+	k_mutex_unlock(&req_lock);
+
+	return 0;
+}
+
+int at_cmd_write(const char *cmd, char *resp, size_t resp_size,
+		 enum at_cmd_state *state)
+{
+	struct k_poll_signal signal;
+	struct k_poll_event event = K_POLL_EVENT_INITIALIZER(
+		K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &signal);
+	struct at_cmd_request req = {
+		.cmd = cmd,
+		.resp = resp,
+		.resp_size = resp_size,
+		.signal = &signal,
+	};
+
+	k_poll_signal_init(&signal);
+
+	int err = at_cmd_submit(&req);
+
+	if (err) {
+		return err;
+	}
+
+	err = k_poll(&event, 1, K_FOREVER);
+	if (err) {
+		return err;
+	}
+
+	if (state != NULL) {
+		*state = req.state;
+	}
+
+	return req.result;
+}
+
+/* Internal function. URC lock must be held. */
+static int urc_handler_add(const char *prefix)
+{
+	size_t i = 0;
+
+	while ((i < urc_handler_cnt) &&
+	       (strcmp(urc_handlers[i].prefix, prefix) < 0)) {
+		i++;
+	}
+
+	if ((i < urc_handler_cnt) && !strcmp(urc_handlers[i].prefix, prefix)) {
+		return 0;
+	}
+
+	if (urc_handler_cnt == ARRAY_SIZE(urc_handlers)) {
+		return -ENOMEM;
+	}
+
+	/* Table is kept sorted for the binary search of the parser. */
+	memmove(&urc_handlers[i + 1], &urc_handlers[i],
+		(urc_handler_cnt - i) * sizeof(urc_handlers[0]));
+	urc_handlers[i].prefix = prefix;
+	urc_handlers[i].handler = urc_dispatch;
+	urc_handler_cnt++;
+
+	return 0;
+}
+
+/* Internal function. URC lock must be held. */
+static void urc_handler_remove(const char *prefix)
+{
+	struct at_cmd_urc_subscriber *sub;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&urc_subscribers, sub, node) {
+		if (!strcmp(sub->prefix, prefix)) {
+			/* Prefix is still used by another subscriber. Table
+			 * must point to a prefix that stays valid.
+			 */
+			for (size_t i = 0; i < urc_handler_cnt; i++) {
+				if (!strcmp(urc_handlers[i].prefix, prefix)) {
+					urc_handlers[i].prefix = sub->prefix;
+				}
+			}
+			return;
+		}
+	}
+
+	for (size_t i = 0; i < urc_handler_cnt; i++) {
+		if (!strcmp(urc_handlers[i].prefix, prefix)) {
+			urc_handler_cnt--;
+			memmove(&urc_handlers[i], &urc_handlers[i + 1],
+				(urc_handler_cnt - i) *
+				sizeof(urc_handlers[0]));
+			return;
+		}
+	}
+}
+
+/* Internal function. URC lock must be held. */
+static int urc_stream_update(void)
+{
+	return at_parser_stream_init(&urc_stream, &urc_param_list,
+				     urc_handlers, urc_handler_cnt,
+				     urc_line_buf, sizeof(urc_line_buf),
+				     NULL);
+}
+
+int at_cmd_urc_subscribe(struct at_cmd_urc_subscriber *sub)
+{
+	if ((sub == NULL) || (sub->prefix == NULL) || (sub->handler == NULL)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&urc_lock, K_FOREVER);
+
+	struct at_cmd_urc_subscriber *it;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&urc_subscribers, it, node) {
+		if (it == sub) {
+			k_mutex_unlock(&urc_lock);
+			return -EALREADY;
+		}
+	}
+
+	int err = urc_handler_add(sub->prefix);
+
+	if (!err) {
+		sys_slist_append(&urc_subscribers, &sub->node);
+		err = urc_stream_update();
+	}
+
+	k_mutex_unlock(&urc_lock);
+
+	return err;
+}
+
+int at_cmd_urc_unsubscribe(struct at_cmd_urc_subscriber *sub)
+{
+	if (sub == NULL) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&urc_lock, K_FOREVER);
+
+	int err = 0;
+
+	if (sys_slist_find_and_remove(&urc_subscribers, &sub->node)) {
+		urc_handler_remove(sub->prefix);
+		err = urc_stream_update();
+	} else {
+		err = -ENOENT;
+	}
+
+	k_mutex_unlock(&urc_lock);
+
+	return err;
+}
+
+void at_cmd_monitor_set(at_cmd_monitor_t monitor)
+{
+	k_mutex_lock(&urc_lock, K_FOREVER);
+	urc_monitor = monitor;
+	k_mutex_unlock(&urc_lock);
+}
+
+static int at_cmd_init(struct device *arg)
+{
+	ARG_UNUSED(arg);
+
+	/* String parameters are stored in an arena, so URCs are parsed
+	 * without using the heap.
+	 */
+	int err = at_params_list_arena_init(&urc_param_list,
+					    CONFIG_AT_CMD_URC_PARAMS_MAX,
+					    CONFIG_AT_CMD_RECV_BUF_SIZE);
+
+	if (err) {
+		LOG_ERR("URC parameter list not initialized: %d", err);
+		return err;
+	}
+
+	k_mutex_init(&req_lock);
+	k_mutex_init(&urc_lock);
+	k_delayed_work_init(&req_timeout_work, req_timeout_fn);
+	sys_slist_init(&req_queue);
+	sys_slist_init(&urc_subscribers);
+
+	err = urc_stream_update();
+	if (err) {
+		return err;
+	}
+
+	at_socket_fd = socket(AF_LTE, 0, NPROTO_AT);
+	if (at_socket_fd == INVALID_DESCRIPTOR) {
+		LOG_ERR("Creating at_socket failed");
+		return -EFAULT;
+	}
+
+	fds.fd = at_socket_fd;
+	fds.events = ZSOCK_POLLIN;
+
+	k_thread_create(&at_cmd_thread, at_cmd_thread_stack,
+			K_THREAD_STACK_SIZEOF(at_cmd_thread_stack),
+			at_cmd_thread_fn,
+			NULL, NULL, NULL,
+			THREAD_PRIORITY, 0, K_NO_WAIT);
+
+	return 0;
+}
+
+SYS_INIT(at_cmd_init, APPLICATION, CONFIG_AT_CMD_INIT_PRIORITY);
@@ -4,7 +4,6 @@
  * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
  */
 
-#include <ctype.h>
 #include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -18,146 +17,215 @@
 #define AT_CMD_PARAM_SEPARATOR ','
 #define AT_CMD_SEPARATOR ';'
 
-/* Internal function. Parameters cannot be null. String must be null terminated.
- */
-static int at_parse_param_u32(char *at_str, u32_t *val,
-				size_t *consumed)
+/* Magnitude of the lowest accepted negative value (INT32_MIN). */
+#define AT_PARAM_NEGATIVE_MAX ((u32_t)INT32_MAX + 1)
+
+
+static inline bool is_param_space(char c)
 {
-	u32_t value = 0;
-	u32_t check_value;
-	bool negative = false;
+	return (c == ' ') || (c == '\t');
+}
 
-	*consumed = 0;
 
-	if (*at_str == '-' && isdigit(*(at_str + 1))) {
-		at_str++;
-		(*consumed)++;
-		negative = true;
-	} else if (!isdigit(*at_str)) {
-		return -EINVAL;
+static inline bool is_param_end(char c)
+{
+	return (c == '\0') || (c == AT_CMD_PARAM_SEPARATOR) ||
+	       (c == AT_CMD_SEPARATOR) || (c == '\r') || (c == '\n');
+}
+
+
+/* Internal function. Returns value of the digit or a value not lower than
+ * the base if the character is not a digit in the given base.
+ */
+static inline u32_t digit_get(char c, u32_t base)
+{
+	u32_t digit = (u8_t)(c - '0');
+
+	if ((digit < 10) || (base == 10)) {
+		return digit;
 	}
 
-	while (isdigit(*at_str)) {
-		if (value > UINT32_MAX - 1) {
-			return -EINVAL;
-		}
-		check_value = value * 10;
-		value = check_value + ((*at_str) - '0');
+	/* Clearing the bit 0x20 converts lowercase letters to uppercase. */
+	digit = (u8_t)((c & ~0x20) - 'A');
 
-		if ((value < check_value) || (value == UINT32_MAX)) {
-			return -EINVAL;
+	return (digit < 6) ? (digit + 10) : base;
+}
+
+
+/* Internal function. Parameters cannot be null. String must be null terminated.
+ *
+ * Parses digits of a numeric value. Parsing stops on the first character that
+ * is not a digit. Returns pointer to that character or NULL if the value does
+ * not fit into 32 bits.
+ */
+static char *at_parse_digits(char *at_str, u32_t base, u32_t *val)
+{
+	/* Limits are constant for each base, no division is done at runtime. */
+	const u32_t max_mul = (base == 10) ? (UINT32_MAX / 10) :
+					     (UINT32_MAX / 16);
+	const u32_t max_digit = (base == 10) ? (UINT32_MAX % 10) :
+					       (UINT32_MAX % 16);
+	u32_t value = 0;
+	u32_t digit;
+
+	while ((digit = digit_get(*at_str, base)) < base) {
+		if ((value > max_mul) ||
+		    ((value == max_mul) && (digit > max_digit))) {
+			return NULL;
 		}
+		value = value * base + digit;
 		at_str++;
-		(*consumed)++;
-	}
-
-	if (negative) {
-		value = (u32_t)(0 - value);
 	}
 
 	*val = value;
-	return 0;
+	return at_str;
 }
 
 
 /* Internal function. Parameters cannot be null. String must be null terminated.
+ *
+ * Checks if the parameter value between @p at_str and @p value_end is
+ * a decimal number (optionally negative) or a hexadecimal number with
+ * the 0x prefix, that fits into 32 bits. The value is scanned only until
+ * the first character that is not a digit.
  */
-static int at_parse_param_numeric(char *at_str,
-				  struct at_param_list *list,
-				  size_t index, size_t *consumed)
+static bool at_parse_param_numeric(char *at_str, const char *value_end,
+				   u32_t *val)
 {
-	size_t num_spaces = at_params_space_count_get(&at_str);
+	bool negative = false;
+	u32_t base = 10;
+
+	if (*at_str == '-') {
+		negative = true;
+		at_str++;
+	} else if ((at_str[0] == '0') && ((at_str[1] == 'x') ||
+					  (at_str[1] == 'X'))) {
+		base = 16;
+		at_str += 2;
+	}
 
-	u32_t val;
-	size_t consumed_bytes;
-	u32_t err = at_parse_param_u32(at_str, &val, &consumed_bytes);
+	if (digit_get(*at_str, base) >= base) {
+		return false;
+	}
 
-	if (err) {
-		*consumed = 0;
-		return -EINVAL;
+	char *digits_end = at_parse_digits(at_str, base, val);
+
+	if (digits_end != value_end) {
+		/* Value overflows or it is followed by other characters. */
+		return false;
 	}
 
-	if (val <= USHRT_MAX) {
-		err = at_params_short_put(list, index, (u16_t)(val));
-	} else {
-		err = at_params_int_put(list, index, val);
+	if (negative) {
+		if (*val > AT_PARAM_NEGATIVE_MAX) {
+			return false;
+		}
+		*val = (u32_t)(0 - *val);
 	}
 
-	*consumed = consumed_bytes + num_spaces;
-	return 0;
+	return true;
 }
 
 
 /* Internal function. Parameters cannot be null. String must be null terminated.
+ *
+ * Parses a parameter that is not quoted. The parameter ends on the parameter
+ * separator, the command separator or the end of line. Spaces in front of
+ * the separator are not part of the value. The value is stored as a number
+ * if it is numeric, otherwise it is stored as a string.
  */
-static int at_parse_param_string(char *at_str,
-				 struct at_param_list *list,
-				 size_t index, size_t *consumed)
+static int at_parse_param_unquoted(char *at_str, struct at_param_list *list,
+				   size_t index, size_t *consumed)
 {
-	u16_t str_len;
-	bool in_double_quotes = false;
-	char *param_value_start = 0;
+	char *value_start = at_str;
+	char *value_end = at_str;
 
-	if (at_str == NULL || *at_str == '\0') {
-		return 0;
+	while (!is_param_end(*at_str)) {
+		if (!is_param_space(*at_str)) {
+			value_end = at_str + 1;
+		}
+		at_str++;
 	}
 
-	size_t spaces = at_params_space_count_get(&at_str);
+	*consumed = at_str - value_start;
 
-	if (*at_str == '\"') {
-		at_str++;
-		in_double_quotes = true;
+	if (value_end == value_start) {
+		return at_params_clear(list, index);
 	}
 
-	param_value_start = at_str;
+	u32_t val = 0;
 
-	while ((*at_str != '\0') && (*at_str != '\r')
-		&& ((!in_double_quotes
-		&& ((*at_str != AT_CMD_SEPARATOR)
-		|| (*at_str != AT_CMD_PARAM_SEPARATOR)))
-		|| (in_double_quotes && (*at_str != '\"')))) {
-		at_str++;
+	if (at_parse_param_numeric(value_start, value_end, &val)) {
+		if (val <= USHRT_MAX) {
+			return at_params_short_put(list, index, (u16_t)val);
+		}
+		return at_params_int_put(list, index, val);
 	}
 
-	if (in_double_quotes &&
-	    ((*at_str == AT_CMD_SEPARATOR) || (*at_str == '\0'))) {
+	return at_params_string_put(list, index, value_start,
+				    value_end - value_start);
+}
+
+
+/* Internal function. Parameters cannot be null. String must be null terminated
+ * and start with the opening double quote.
+ *
+ * The closing double quote must be on the same line.
+ */
+static int at_parse_param_quoted(char *at_str, struct at_param_list *list,
+				 size_t index, size_t *consumed)
+{
+	char *value_start = at_str + 1;
+	char *value_end = value_start;
+
+	while ((*value_end != '\"') && (*value_end != '\0') &&
+	       (*value_end != '\r') && (*value_end != '\n')) {
+		value_end++;
+	}
+
+	if (*value_end != '\"') {
+		/* String is not terminated. */
 		return -EINVAL;
 	}
 
-	str_len = at_str - param_value_start;
-	*consumed = str_len + spaces;
+	at_str = value_end + 1;
 
-	if (in_double_quotes && (*at_str == '\"')) {
+	while (is_param_space(*at_str)) {
 		at_str++;
-		*consumed += 2;
 	}
 
-	return at_params_string_put(list, index, param_value_start, str_len);
+	*consumed = at_str - (value_start - 1);
+
+	return at_params_string_put(list, index, value_start,
+				    value_end - value_start);
 }
 
 
 /* Internal function. Parameters cannot be null. String must be null terminated.
+ *
+ * Parameter is classified as empty, numeric, quoted string or unquoted string
+ * in one pass over the characters.
  */
 static int at_parse_param(char *at_params_str,
 			  struct at_param_list *list, size_t index,
 			  size_t *consumed)
 {
-	if (at_params_str == NULL || *at_params_str == '\0' ||
-	    *at_params_str == AT_CMD_PARAM_SEPARATOR ||
-	    *at_params_str == AT_CMD_SEPARATOR) {
-		*consumed = 0;
-		(void)at_params_clear(list, index);
-		return 0;
-	}
+	char *at_str = at_params_str;
+	int err;
 
-	int err = at_parse_param_numeric(at_params_str, list, index,
-					 consumed);
+	*consumed = 0;
 
-	if (err) {
-		err = at_parse_param_string(at_params_str, list, index,
-					    consumed);
+	while (is_param_space(*at_str)) {
+		at_str++;
 	}
 
+	if (*at_str == '\"') {
+		err = at_parse_param_quoted(at_str, list, index, consumed);
+	} else {
+		err = at_parse_param_unquoted(at_str, list, index, consumed);
+	}
+
+	*consumed += at_str - at_params_str;
+
 	return err;
 }
 
@@ -197,7 +265,11 @@ int at_parser_max_params_from_str(char *str,
 		if (i < (max_params_count - 1) && *str != '\0') {
 			if (*str == AT_CMD_PARAM_SEPARATOR) {
 				str++;
-			} else if ((*str == '\r') || (*str == '\n')) {
+			} else if ((*str == AT_CMD_SEPARATOR) ||
+				   (*str == '\r') || (*str == '\n')) {
+				/* Parameters of the next command or response
+				 * are not parsed.
+				 */
 				return 0;
 			} else {
 				return -EINVAL;
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <stdbool.h>
+#include <ctype.h>
+#include <string.h>
+#include <zephyr.h>
+#include <zephyr/types.h>
+
+#include <at_cmd_parser.h>
+#include <at_utils.h>
+
+#define AT_CMD_SEPARATOR ';'
+#define AT_CMD_PREFIX "AT"
+
+/* Internal function. Parameters cannot be null. */
+static const struct at_parser_prefix_handler *handler_find(
+		const struct at_parser_stream *stream, const char *prefix)
+{
+	size_t low = 0;
+	size_t high = stream->handler_cnt;
+
+	while (low < high) {
+		size_t mid = low + (high - low) / 2;
+		int cmp = strcmp(prefix, stream->handlers[mid].prefix);
+
+		if (cmp == 0) {
+			return &stream->handlers[mid];
+		} else if (cmp < 0) {
+			high = mid;
+		} else {
+			low = mid + 1;
+		}
+	}
+
+	return NULL;
+}
+
+
+/* Internal function. Parameter cannot be null. Line must be null
+ * terminated.
+ */
+static bool is_echo(const char *line)
+{
+	/* Echoed commands start with AT, responses never do. */
+	for (size_t i = 0; i < strlen(AT_CMD_PREFIX); i++) {
+		if (toupper((unsigned char)line[i]) != AT_CMD_PREFIX[i]) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/* Internal function. Parameters cannot be null. Segment must be null
+ * terminated.
+ */
+static int segment_dispatch(struct at_parser_stream *stream, char *segment)
+{
+	static char no_params[] = "";
+	char *params = no_params;
+
+	(void)at_params_space_count_get(&segment);
+
+	char *prefix_end = segment;
+
+	while ((*prefix_end != '\0') && (*prefix_end != ':') &&
+	       (*prefix_end != '=') && (*prefix_end != '?')) {
+		prefix_end++;
+	}
+
+	if (prefix_end == segment) {
+		return 0;
+	}
+
+	if (*prefix_end != '\0') {
+		params = prefix_end + 1;
+		*prefix_end = '\0';
+	}
+
+	const struct at_parser_prefix_handler *h = handler_find(stream,
+								segment);
+
+	if (h == NULL) {
+		return 0;
+	}
+
+	int err = at_parser_params_from_str(params, stream->list);
+
+	if (err) {
+		return err;
+	}
+
+	h->handler(segment, stream->list, stream->user_data);
+
+	return 0;
+}
+
+
+/* Internal function. Parameters cannot be null. Line must be null
+ * terminated.
+ */
+static int line_dispatch(struct at_parser_stream *stream, char *line)
+{
+	bool in_quotes = false;
+	char *segment = line;
+	int ret = 0;
+
+	(void)at_params_space_count_get(&segment);
+
+	/* Echoed command is not a response, even if its prefix matches. */
+	if (is_echo(segment)) {
+		return 0;
+	}
+
+	for (char *c = line; ; c++) {
+		if (*c == '\"') {
+			in_quotes = !in_quotes;
+		} else if ((*c == '\0') ||
+			   (!in_quotes && (*c == AT_CMD_SEPARATOR))) {
+			bool last = (*c == '\0');
+
+			*c = '\0';
+
+			int err = segment_dispatch(stream, segment);
+
+			if (err && !ret) {
+				ret = err;
+			}
+
+			if (last) {
+				break;
+			}
+
+			segment = c + 1;
+		}
+	}
+
+	return ret;
+}
+
+
+int at_parser_stream_init(struct at_parser_stream *stream,
+			  struct at_param_list *list,
+			  const struct at_parser_prefix_handler *handlers,
+			  size_t handler_cnt, char *buf, size_t buf_size,
+			  void *user_data)
+{
+	if ((stream == NULL) || (list == NULL) || (list->params == NULL) ||
+	    ((handlers == NULL) && (handler_cnt > 0)) ||
+	    (buf == NULL) || (buf_size == 0)) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 1; i < handler_cnt; i++) {
+		if (strcmp(handlers[i - 1].prefix, handlers[i].prefix) >= 0) {
+			/* Handlers must be sorted for binary search. */
+			return -EINVAL;
+		}
+	}
+
+	stream->list = list;
+	stream->handlers = handlers;
+	stream->handler_cnt = handler_cnt;
+	stream->buf = buf;
+	stream->buf_size = buf_size;
+	stream->user_data = user_data;
+	at_parser_stream_reset(stream);
+
+	return 0;
+}
+
+
+void at_parser_stream_reset(struct at_parser_stream *stream)
+{
+	if (stream == NULL) {
+		return;
+	}
+
+	stream->len = 0;
+	stream->overflow = false;
+}
+
+
+int at_parser_stream_feed(struct at_parser_stream *stream,
+			  const char *data, size_t len)
+{
+	if ((stream == NULL) || (data == NULL)) {
+		return -EINVAL;
+	}
+
+	int ret = 0;
+
+	for (size_t i = 0; i < len; i++) {
+		char c = data[i];
+
+		if ((c != '\r') && (c != '\n') && (c != '\0')) {
+			/* One byte is left for the terminating null. */
+			if (stream->len + 1 < stream->buf_size) {
+				stream->buf[stream->len++] = c;
+			} else {
+				stream->overflow = true;
+			}
+			continue;
+		}
+
+		int err = 0;
+
+		if (stream->overflow) {
+			/* Line is dropped to stay in sync with the input. */
+			err = -ENOBUFS;
+		} else if (stream->len > 0) {
+			stream->buf[stream->len] = '\0';
+			err = line_dispatch(stream, stream->buf);
+		}
+
+		at_parser_stream_reset(stream);
+
+		if (err && !ret) {
+			ret = err;
+		}
+	}
+
+	return ret;
+}
@@ -23,12 +23,16 @@ static void at_param_init(struct at_param *param)
 
 
 /* Internal function. */
-static void at_param_clear(struct at_param *param)
+static void at_param_clear(const struct at_param_list *list,
+			   struct at_param *param)
 {
 	__ASSERT(param != NULL, "Parameter pointer cannot be NULL.\n");
 
 	if (param->type == AT_PARAM_TYPE_STRING) {
-		k_free(param->value.str_val);
+		/* Arena memory is released when the whole list is cleared. */
+		if (list->arena == NULL) {
+			k_free(param->value.str_val);
+		}
 	} else if (param->type == AT_PARAM_TYPE_NUM_INT) {
 		param->value.int_val = 0;
 	} else if (param->type == AT_PARAM_TYPE_NUM_SHORT) {
@@ -53,6 +57,27 @@ static struct at_param *at_params_get(const struct at_param_list *list,
 }
 
 
+/* Internal function. List cannot be null. */
+static char *at_params_str_alloc(const struct at_param_list *list,
+				 size_t size)
+{
+	struct at_params_arena *arena = list->arena;
+
+	if (arena == NULL) {
+		return k_malloc(size);
+	}
+
+	if (size > arena->size - arena->used) {
+		return NULL;
+	}
+
+	char *str = &arena->buf[arena->used];
+
+	arena->used += size;
+	return str;
+}
+
+
 /* Internal function. Parameter cannot be null. */
 static size_t at_param_size(const struct at_param *param)
 {
@@ -86,6 +111,39 @@ int at_params_list_init(struct at_param_list *list,
 	}
 
 	list->param_count = max_params_count;
+	list->arena = NULL;
+
+	return 0;
+}
+
+
+int at_params_list_arena_init(struct at_param_list *list,
+			      size_t max_params_count, size_t arena_size)
+{
+	if (list == NULL) {
+		return -EINVAL;
+	}
+
+	if (list->params != NULL) {
+		return -EACCES;
+	}
+
+	/* Parameters and arena are allocated in one block, so the list
+	 * is freed in the same way as a list without arena.
+	 */
+	size_t params_size = max_params_count * sizeof(struct at_param);
+
+	list->params = k_calloc(1, params_size +
+				sizeof(struct at_params_arena) + arena_size);
+	if (list->params == NULL) {
+		return -ENOMEM;
+	}
+
+	list->param_count = max_params_count;
+	list->arena = (struct at_params_arena *)((u8_t *)list->params +
+						 params_size);
+	list->arena->size = arena_size;
+	list->arena->used = 0;
 
 	return 0;
 }
@@ -101,9 +159,13 @@ void at_params_list_clear(struct at_param_list *list)
 		 ++i) {
 		struct at_param *params = list->params;
 
-		at_param_clear(&params[i]);
+		at_param_clear(list, &params[i]);
 		at_param_init(&params[i]);
 	}
+
+	if (list->arena != NULL) {
+		list->arena->used = 0;
+	}
 }
 
 
@@ -118,6 +180,7 @@ void at_params_list_free(struct at_param_list *list)
 	list->param_count = 0;
 	k_free(list->params);
 	list->params = NULL;
+	list->arena = NULL;
 }
 
 
@@ -134,7 +197,7 @@ int at_params_clear(struct at_param_list *list, size_t index)
 		return -EINVAL;
 	}
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 	at_param_init(param);
 	return 0;
 }
@@ -153,7 +216,7 @@ int at_params_short_put(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 
 	param->type = AT_PARAM_TYPE_NUM_SHORT;
 	param->value.short_val = (value & USHRT_MAX);
@@ -174,7 +237,7 @@ int at_params_int_put(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 
 	param->type = AT_PARAM_TYPE_NUM_INT;
 	param->value.int_val = value;
@@ -195,7 +258,7 @@ int at_params_string_put(const struct at_param_list *list, size_t index,
 		return -EINVAL;
 	}
 
-	char *param_value = k_malloc(str_len + 1);
+	char *param_value = at_params_str_alloc(list, str_len + 1);
 
 	if (param_value == NULL) {
 		return -ENOMEM;
@@ -204,7 +267,7 @@ int at_params_string_put(const struct at_param_list *list, size_t index,
 	memcpy(param_value, str, str_len);
 	param_value[str_len] = '\0';
 
-	at_param_clear(param);
+	at_param_clear(list, param);
 	param->type = AT_PARAM_TYPE_STRING;
 	param->value.str_val =	param_value;
 
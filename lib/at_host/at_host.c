@@ -12,21 +12,16 @@ LOG_MODULE_REGISTER(LOG_DOMAIN);
 #include <zephyr.h>
 #include <stdio.h>
 #include <uart.h>
-#include <net/socket.h>
 #include <string.h>
 #include <init.h>
+#include <at_cmd.h>
 
 #define CONFIG_UART_0_NAME 	"UART_0"
 #define CONFIG_UART_1_NAME 	"UART_1"
 #define CONFIG_UART_2_NAME 	"UART_2"
 
-#define INVALID_DESCRIPTOR 	-1
-
 #define UART_RX_BUF_SIZE 	CONFIG_AT_HOST_UART_BUF_SIZE
 
-#define THREAD_STACK_SIZE 	(CONFIG_AT_HOST_SOCKET_BUF_SIZE + 512)
-#define THREAD_PRIORITY 	K_PRIO_PREEMPT(CONFIG_AT_HOST_THREAD_PRIO)
-
 /**
  * @brief Size of the buffer used to parse an AT command.
  * Defines the maximum number of characters of an AT command (including null
@@ -53,34 +48,54 @@ enum select_uart {
 
 static enum term_modes term_mode;
 static struct device *uart_dev;
-static int at_socket_fd = INVALID_DESCRIPTOR;
-static struct pollfd fds[1];
-static int nfds;
-static u8_t at_buf[AT_MAX_CMD_LEN];
+/* One byte more for the terminating null. */
+static char at_buf[AT_MAX_CMD_LEN + 1];
 static size_t at_buf_len;
 static struct k_work at_cmd_send_work;
-static struct k_thread socket_thread;
-static K_THREAD_STACK_DEFINE(socket_thread_stack, THREAD_STACK_SIZE);
-static struct k_mutex socket_mutex;
+static char at_resp_buf[CONFIG_AT_HOST_SOCKET_BUF_SIZE];
+static struct at_cmd_request at_req;
 
 
 static const char termination[3] = { '\0', '\r', '\n' };
 
+static void uart_write(const char *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		uart_poll_out(uart_dev, data[i]);
+	}
+}
+
+static void at_cmd_done(struct at_cmd_request *req)
+{
+	/* Response includes the final result code. */
+	uart_write(req->resp, req->resp_len);
+
+	/* Command buffer is used until the response is received. */
+	uart_irq_rx_enable(uart_dev);
+}
+
+static void at_notification_print(const char *data, size_t len)
+{
+	uart_write(data, len);
+}
+
 static void at_cmd_send(struct k_work *work)
 {
-	int bytes_sent;
+	int err;
 
 	ARG_UNUSED(work);
 
-	k_mutex_lock(&socket_mutex, K_FOREVER);
-	bytes_sent = send(at_socket_fd, at_buf, at_buf_len, 0);
-	k_mutex_unlock(&socket_mutex);
+	at_buf[at_buf_len] = '\0';
+	at_req.cmd = at_buf;
+	at_req.resp = at_resp_buf;
+	at_req.resp_size = sizeof(at_resp_buf);
+	at_req.done = at_cmd_done;
 
-	if (bytes_sent <= 0) {
-		LOG_ERR("Could not send AT command to modem: %d", bytes_sent);
+	err = at_cmd_submit(&at_req);
+	if (err) {
+		LOG_ERR("Could not send AT command to modem: %d", err);
+		uart_irq_rx_enable(uart_dev);
 	}
-
-	uart_irq_rx_enable(uart_dev);
 }
 
 static void uart_rx_handler(u8_t character)
@@ -191,42 +206,6 @@ static int at_uart_init(char *uart_dev_name)
 	return err;
 }
 
-static void socket_thread_fn(void *arg1, void *arg2, void *arg3)
-{
-	u8_t at_read_buff[CONFIG_AT_HOST_SOCKET_BUF_SIZE] = {0};
-	int err;
-	int r_bytes;
-
-	ARG_UNUSED(arg1);
-	ARG_UNUSED(arg2);
-	ARG_UNUSED(arg3);
-
-	while (1) {
-		/* Poll the socket for incoming data. */
-		err = poll(fds, nfds, K_FOREVER);
-		if (err < 0) {
-			LOG_ERR("Poll error: %d\n", err);
-		}
-
-		k_mutex_lock(&socket_mutex, K_FOREVER);
-		/* Read AT socket in non-blocking mode. */
-		r_bytes = recv(at_socket_fd, at_read_buff,
-				sizeof(at_read_buff), MSG_DONTWAIT);
-		k_mutex_unlock(&socket_mutex);
-
-		/* Forward the data over UART if any. */
-		/* If no data, errno is set to EGAIN and we will try again. */
-		if (r_bytes > 0) {
-			/* Poll out what is in the buffer gathered from
-			 * the modem.
-			 */
-			for (size_t i = 0; i < r_bytes; i++) {
-				uart_poll_out(uart_dev, at_read_buff[i]);
-			}
-		}
-	}
-}
-
 static int at_host_init(struct device *arg)
 {
 	char *uart_dev_name;
@@ -263,29 +242,15 @@ static int at_host_init(struct device *arg)
 	if (err) {
 		LOG_ERR("UART could not be initialized: %d", err);
 		return -EFAULT;
-	} else {
-		/* AT socket creation. Handle must be valid to continue. */
-		at_socket_fd = socket(AF_LTE, 0, NPROTO_AT);
-		fds[0].fd = at_socket_fd;
-		fds[0].events = ZSOCK_POLLIN;
-		nfds += 1;
-
-		if (at_socket_fd == INVALID_DESCRIPTOR) {
-			LOG_ERR("Creating at_socket failed\n");
-			return -EFAULT;
-		}
 	}
 
-	k_mutex_init(&socket_mutex);
+	/* Data from the modem is read by the AT command service. */
+	at_cmd_monitor_set(at_notification_print);
+
 	k_work_init(&at_cmd_send_work, at_cmd_send);
-	k_thread_create(&socket_thread, socket_thread_stack,
-			K_THREAD_STACK_SIZEOF(socket_thread_stack),
-			socket_thread_fn,
-			NULL, NULL, NULL,
-			THREAD_PRIORITY, 0, K_NO_WAIT);
 	uart_irq_rx_enable(uart_dev);
 
 	return err;
 }
 
-SYS_INIT(at_host_init, APPLICATION, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+SYS_INIT(at_host_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
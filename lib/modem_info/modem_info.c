@@ -4,11 +4,11 @@
  * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
  */
 
+#include <at_cmd.h>
 #include <at_cmd_parser.h>
 #include <device.h>
 #include <errno.h>
 #include <modem_info.h>
-#include <net/socket.h>
 #include <stdio.h>
 #include <string.h>
 #include <zephyr.h>
@@ -17,10 +17,6 @@
 
 LOG_MODULE_REGISTER(modem_info);
 
-#define INVALID_DESCRIPTOR	-1
-#define THREAD_STACK_SIZE	(CONFIG_MODEM_INFO_SOCKET_BUF_SIZE + 512)
-#define THREAD_PRIORITY		K_PRIO_PREEMPT(CONFIG_MODEM_INFO_THREAD_PRIO)
-
 #define AT_CMD_CESQ		"AT%CESQ"
 #define AT_CMD_CESQ_ON		"AT%CESQ=1"
 #define AT_CMD_CESQ_OFF		"AT%CESQ=0"
@@ -36,7 +32,6 @@ LOG_MODULE_REGISTER(modem_info);
 #define AT_CMD_FW_VERSION	"AT+CGMR"
 #define AT_CMD_CRSM		"AT+CRSM"
 #define AT_CMD_ICCID		"AT+CRSM=176,12258,0,0,10"
-#define AT_CMD_SUCCESS_SIZE	5
 #define RSRP_PARAM_INDEX 0
 #define RSRP_PARAM_COUNT 2
 #define RSRP_OFFSET_VAL 141
@@ -73,8 +68,6 @@ LOG_MODULE_REGISTER(modem_info);
 
 #define CMD_SIZE(x) (strlen(x) - 1)
 
-static const char success[] = "OK";
-
 struct modem_info_data {
 	const char *cmd;
 	u8_t param_index;
@@ -190,47 +183,18 @@ static const char *const modem_data_name[] = {
 static rsrp_cb_t modem_info_rsrp_cb;
 
 static struct at_param_list m_param_list;
-static struct k_thread socket_thread;
-static K_THREAD_STACK_DEFINE(socket_thread_stack, THREAD_STACK_SIZE);
-static struct k_mutex socket_mutex;
-static int at_socket_fd = INVALID_DESCRIPTOR;
-static struct pollfd fds;
-static int nfds;
-
-static int at_cmd_send(int fd, const char *cmd, size_t size, char *resp_buffer)
-{
-	int len;
-	size_t ret = 0;
-
-	k_mutex_lock(&socket_mutex, K_FOREVER);
 
-	LOG_DBG("send: %s\n", cmd);
-	len = send(fd, cmd, size, 0);
-	LOG_DBG("len: %d\n", len);
-	if (len != size) {
-		LOG_DBG("send: failed\n");
-		ret = -EIO;
-	}
-
-	if (resp_buffer != NULL && ret == 0) {
-		len = recv(fd, resp_buffer, CONFIG_MODEM_INFO_BUFFER_SIZE, 0);
+static int at_cmd_send(const char *cmd, char *resp_buffer)
+{
+	int err = at_cmd_write(cmd, resp_buffer, CONFIG_MODEM_INFO_BUFFER_SIZE,
+			       NULL);
 
-		if (memcmp(success,
-			   &resp_buffer[len-AT_CMD_SUCCESS_SIZE],
-			   strlen(success)) != 0) {
-			LOG_ERR("recv: %s", resp_buffer);
-			ret = -EIO;
-		}
+	if (err) {
+		LOG_ERR("%s failed (err: %d)", log_strdup(cmd), err);
+		return -EIO;
 	}
 
-	k_mutex_unlock(&socket_mutex);
-
-	return ret;
-}
-
-static bool is_cesq_notification(char *buf, size_t len)
-{
-	return strstr(buf, AT_CMD_CESQ_RESP) ? true : false;
+	return 0;
 }
 
 static void flip_iccid_string(char *buf)
@@ -331,10 +295,7 @@ int modem_info_short_get(enum modem_info info, u16_t *buf)
 		return -EINVAL;
 	}
 
-	err = at_cmd_send(at_socket_fd,
-			modem_data[info]->cmd,
-			strlen(modem_data[info]->cmd),
-			recv_buf);
+	err = at_cmd_send(modem_data[info]->cmd, recv_buf);
 
 	if (err) {
 		return err;
@@ -368,10 +329,7 @@ int modem_info_string_get(enum modem_info info, char *buf)
 		return -EINVAL;
 	}
 
-	err = at_cmd_send(at_socket_fd,
-			modem_data[info]->cmd,
-			strlen(modem_data[info]->cmd),
-			recv_buf);
+	err = at_cmd_send(modem_data[info]->cmd, recv_buf);
 
 	if (err) {
 		return err;
@@ -411,86 +369,71 @@ int modem_info_string_get(enum modem_info info, char *buf)
 	return len <= 0 ? -ENOTSUP : len;
 }
 
-static void modem_info_rsrp_subscribe_thread(void *arg1, void *arg2, void *arg3)
+static void cesq_notification_handler(const char *prefix,
+				      struct at_param_list *list,
+				      void *user_data)
 {
-	char buf[CONFIG_MODEM_INFO_BUFFER_SIZE] = {0};
 	u16_t param_value;
 	int err;
-	int r_bytes;
-	int len;
 
-	ARG_UNUSED(arg1);
-	ARG_UNUSED(arg2);
-	ARG_UNUSED(arg3);
+	ARG_UNUSED(prefix);
+	ARG_UNUSED(user_data);
 
-	err = at_cmd_send(at_socket_fd,
-			AT_CMD_CESQ_ON,
-			strlen(AT_CMD_CESQ_ON),
-			NULL);
+	if (at_params_valid_count_get(list) < RSRP_PARAM_COUNT) {
+		return;
+	}
 
+	err = at_params_short_get(list, RSRP_PARAM_INDEX, &param_value);
 	if (err) {
-		LOG_ERR("AT cmd error: %d\n", err);
+		return;
 	}
 
-	while (1) {
-		err = poll(&fds, nfds, K_FOREVER);
-		if (err < 0) {
-			LOG_ERR("Poll error: %d\n", err);
-			continue;
-		} else if (err == 0) {
-			LOG_DBG("Timeout");
-			k_sleep(200);
-			continue;
-		}
+	modem_info_rsrp_cb(param_value);
+}
 
-		k_mutex_lock(&socket_mutex, K_FOREVER);
-		r_bytes = recv(at_socket_fd, buf,
-				sizeof(buf), MSG_DONTWAIT);
-		k_mutex_unlock(&socket_mutex);
-
-		if (is_cesq_notification(buf, r_bytes)) {
-			modem_info_parse(modem_data[MODEM_INFO_RSRP],
-					buf);
-			len = modem_info_short_get(MODEM_INFO_RSRP,
-						   &param_value);
-			modem_info_rsrp_cb(param_value);
-		}
+static struct at_cmd_urc_subscriber cesq_sub = {
+	.prefix = AT_CMD_CESQ_RESP,
+	.handler = cesq_notification_handler,
+};
+
+static void cesq_on_done(struct at_cmd_request *req)
+{
+	if (req->result) {
+		LOG_ERR("AT cmd error: %d", req->result);
 	}
 }
 
+static struct at_cmd_request cesq_on_req = {
+	.cmd = AT_CMD_CESQ_ON,
+	.done = cesq_on_done,
+};
+
 int modem_info_rsrp_register(rsrp_cb_t cb)
 {
 	modem_info_rsrp_cb = cb;
 
-	k_thread_create(&socket_thread, socket_thread_stack,
-			K_THREAD_STACK_SIZEOF(socket_thread_stack),
-			modem_info_rsrp_subscribe_thread,
-			NULL, NULL, NULL,
-			THREAD_PRIORITY, 0, K_NO_WAIT);
+	/* Notifications are parsed by the AT command service. */
+	int err = at_cmd_urc_subscribe(&cesq_sub);
 
-	return 0;
+	if (err && (err != -EALREADY)) {
+		return err;
+	}
+
+	/* Caller does not wait for the response. */
+	return at_cmd_submit(&cesq_on_req);
 }
 
 int modem_info_init(void)
 {
-	/* Init at_cmd_parser storage module */
-	int err = at_params_list_init(&m_param_list,
+	/* Init at_cmd_parser storage module. String parameters are copied
+	 * to the arena of the list, so responses are parsed without using
+	 * the heap. Every string occupies one byte more than in the response.
+	 */
+	int err = at_params_list_arena_init(&m_param_list,
+				CONFIG_MODEM_INFO_MAX_AT_PARAMS_RSP,
+				CONFIG_MODEM_INFO_BUFFER_SIZE +
 				CONFIG_MODEM_INFO_MAX_AT_PARAMS_RSP);
 
-	/* Occupy socket for AT command transmission */
-	at_socket_fd = socket(AF_LTE, 0, NPROTO_AT);
-	fds.fd = at_socket_fd;
-	fds.events = ZSOCK_POLLIN;
-	nfds += 1;
-
-	if (at_socket_fd == INVALID_DESCRIPTOR) {
-		LOG_ERR("Creating at_socket failed\n");
-		return -EFAULT;
-	}
-
-	/* Init thread for RSRP subscription */
-	k_mutex_init(&socket_mutex);
-
 	return err;
 }
 
@@ -10,13 +10,21 @@ import logging
 
 def main():
     parser = argparse.ArgumentParser(description='Calculating stats for events.')
-    parser.add_argument('event_csv', help='.csv file to read raw events data')
-    parser.add_argument('event_descr', help='.json file to read events descriptions')
+    parser.add_argument('event_csv', nargs='?',
+                        help='.csv file to read raw events data')
+    parser.add_argument('event_descr', nargs='?',
+                        help='.json file to read events descriptions')
+    parser.add_argument('--columnar',
+                        help='Directory with columnar capture to read instead')
     parser.add_argument('--log', help='Log level')
     parser.add_argument('--start_time', help='Measurement start time[s]')
     parser.add_argument('--end_time', help='Measurement end time[s]')
     args = parser.parse_args()
 
+    if args.columnar is None and \
+       (args.event_csv is None or args.event_descr is None):
+        parser.error('Provide .csv and .json files or columnar capture')
+
     if args.log is not None:
         log_lvl_number = int(getattr(logging, args.log.upper(), None))
     else:
@@ -32,7 +40,8 @@ def main():
     else:
         args.end_time = float(args.end_time)
 
-    sn = StatsNordic(args.event_csv, args.event_descr, log_lvl_number)
+    sn = StatsNordic(args.event_csv, args.event_descr, log_lvl_number,
+                     args.columnar)
     sn.calculate_stats_preset1(args.start_time, args.end_time)
 
 if __name__ == "__main__":
@@ -0,0 +1,247 @@
+# Copyright (c) 2019 Nordic Semiconductor ASA
+# SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+
+from events import EventsData
+from columnar_events import ColumnarEvents
+from enum import Enum
+import argparse
+import json
+
+
+START_EVENT_NAME = 'event_processing_start'
+END_EVENT_NAME = 'event_processing_end'
+MEM_ADDRESS_LABEL = 'mem_address'
+SPAN_LABELS = ['state', 'depth', 'thread']
+
+# Work queues of the Event Manager delivery classes
+DELIVERY_CLASSES = {0: 'default', 1: 'realtime', 2: 'bulk'}
+
+PID = 1
+TID_EVENTS = 1
+TID_SUBMISSIONS = 2
+TID_QUEUE_BASE = 10
+
+
+class EventKind(Enum):
+    SUBMIT = 0
+    PROC_START = 1
+    PROC_END = 2
+    SPAN = 3
+    OTHER = 4
+
+
+class ChromeTraceWriter():
+    """Writes events in Chrome trace event format (JSON array), readable by
+    Perfetto UI and chrome://tracing.
+
+    Events are written when received, so the writer can be used while
+    collecting data. Processing of submitted Event Manager events is written
+    as slice in track of the work queue, linked with the submission by
+    a flow arrow. Spans are written as slices in track of the thread.
+
+    Span ends without a begin (capture started inside the span) are skipped.
+    Spans not ended when the writer is closed are ended at the last
+    timestamp and marked as unterminated.
+    """
+
+    def __init__(self, filename, flush_period=4096):
+        self.file = open(filename, 'w')
+        self.flush_period = flush_period
+        self.record_cnt = 0
+        self.encoder = json.JSONEncoder(separators=(',', ':'))
+        self.event_types = {}
+        self.kinds = {}
+        self.tracks = set()
+        self.flow_id = 0
+        # Last submission and processing start of event at memory address
+        self.submits = {}
+        self.starts = {}
+        # Names of spans open in a thread, indexed by depth
+        self.span_stacks = {}
+        self.last_ts = 0
+
+        self.file.write('[')
+        self._write({'ph': 'M', 'name': 'process_name', 'pid': PID,
+                     'args': {'name': 'Nordic profiler'}})
+
+    def set_event_types(self, event_types):
+        # Dictionary may be extended while capturing
+        self.event_types = event_types
+
+    def _write(self, record):
+        if self.record_cnt > 0:
+            self.file.write(',')
+        self.file.write('\n')
+        self.file.write(self.encoder.encode(record))
+        self.record_cnt += 1
+        # Trace can be opened before it is closed, the closing bracket is
+        # optional in the format
+        if self.record_cnt % self.flush_period == 0:
+            self.file.flush()
+
+    def _track(self, tid, name):
+        if tid not in self.tracks:
+            self.tracks.add(tid)
+            self._write({'ph': 'M', 'name': 'thread_name', 'pid': PID,
+                         'tid': tid, 'args': {'name': name}})
+            self._write({'ph': 'M', 'name': 'thread_sort_index', 'pid': PID,
+                         'tid': tid, 'args': {'sort_index': tid}})
+        return tid
+
+    def _kind(self, type_id):
+        kind = self.kinds.get(type_id)
+        if kind is None:
+            et = self.event_types[type_id]
+            if et.name == START_EVENT_NAME:
+                kind = EventKind.PROC_START
+            elif et.name == END_EVENT_NAME:
+                kind = EventKind.PROC_END
+            elif et.data_descriptions == SPAN_LABELS:
+                kind = EventKind.SPAN
+            elif et.data_descriptions[:1] == [MEM_ADDRESS_LABEL]:
+                kind = EventKind.SUBMIT
+            else:
+                kind = EventKind.OTHER
+            self.kinds[type_id] = kind
+        return kind
+
+    @staticmethod
+    def _timestamp_us(event):
+        return round(event.timestamp * 1000000, 3)
+
+    def _args(self, event):
+        et = self.event_types[event.type_id]
+        args = dict(zip(et.data_descriptions, event.data))
+        if MEM_ADDRESS_LABEL in args:
+            args[MEM_ADDRESS_LABEL] = '0x{:08x}'.format(
+                args[MEM_ADDRESS_LABEL])
+        return args
+
+    def _append_submit(self, event):
+        self.flow_id += 1
+        self.submits[event.data[0]] = (self.flow_id, event.type_id)
+        self._write({'ph': 'X', 'cat': 'submit',
+                     'name': self.event_types[event.type_id].name,
+                     'pid': PID,
+                     'tid': self._track(TID_SUBMISSIONS, 'Submissions'),
+                     'ts': self._timestamp_us(event), 'dur': 0,
+                     'args': self._args(event),
+                     'bind_id': self.flow_id, 'flow_out': True})
+
+    def _append_processing_end(self, event):
+        start = self.starts.pop(event.data[0], None)
+        if start is None:
+            return
+        start_event, submit = start
+
+        delivery_class = start_event.data[1] if len(start_event.data) > 1 \
+                         else 0
+        tid = self._track(TID_QUEUE_BASE + delivery_class,
+                          'Work queue: {}'.format(
+                              DELIVERY_CLASSES.get(delivery_class,
+                                                   delivery_class)))
+        ts = self._timestamp_us(start_event)
+        record = {'ph': 'X', 'cat': 'processing',
+                  'name': 'event_processing',
+                  'pid': PID, 'tid': tid, 'ts': ts,
+                  'dur': round(self._timestamp_us(event) - ts, 3),
+                  'args': self._args(start_event)}
+        if submit is not None:
+            flow_id, type_id = submit
+            record['name'] = self.event_types[type_id].name
+            record['bind_id'] = flow_id
+            record['flow_in'] = True
+        self._write(record)
+
+    def _write_span(self, ph, name, tid, ts, args):
+        self._write({'ph': ph, 'cat': 'span', 'name': name, 'pid': PID,
+                     'tid': tid, 'ts': ts, 'args': args})
+
+    def _append_span(self, event):
+        state, depth, thread = event.data
+        name = self.event_types[event.type_id].name
+        stack = self.span_stacks.setdefault(thread, [])
+        ts = self._timestamp_us(event)
+
+        if state == 0:
+            # Ends of deeper spans were lost, the device ended them before
+            # this span began
+            while len(stack) > depth:
+                self._write_span('E', stack.pop(), thread, ts,
+                                 {'unterminated': True})
+            tid = self._track(thread, 'Thread 0x{:08x}'.format(thread))
+            stack.append(name)
+            self._write_span('B', name, tid, ts, {'depth': depth})
+        elif len(stack) > depth and stack[depth] == name:
+            while len(stack) > depth + 1:
+                self._write_span('E', stack.pop(), thread, ts,
+                                 {'unterminated': True})
+            stack.pop()
+            self._write_span('E', name, thread, ts, {'depth': depth})
+
+    def append(self, event):
+        self.last_ts = max(self.last_ts, self._timestamp_us(event))
+        kind = self._kind(event.type_id)
+        if kind == EventKind.SUBMIT:
+            self._append_submit(event)
+        elif kind == EventKind.PROC_START:
+            # Memory of an event can be reused after the event is processed,
+            # so the processing is linked with the last submission
+            self.starts[event.data[0]] = (event,
+                                          self.submits.pop(event.data[0],
+                                                           None))
+        elif kind == EventKind.PROC_END:
+            self._append_processing_end(event)
+        elif kind == EventKind.SPAN:
+            self._append_span(event)
+        else:
+            self._write({'ph': 'i', 's': 't', 'cat': 'event',
+                         'name': self.event_types[event.type_id].name,
+                         'pid': PID,
+                         'tid': self._track(TID_EVENTS, 'Events'),
+                         'ts': self._timestamp_us(event),
+                         'args': self._args(event)})
+
+    def close(self):
+        for thread, stack in self.span_stacks.items():
+            while stack:
+                self._write_span('E', stack.pop(), thread, self.last_ts,
+                                 {'unterminated': True})
+        self.file.write('\n]\n')
+        self.file.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Exporting events to Chrome trace event format '
+        '(Perfetto UI, chrome://tracing).')
+    parser.add_argument('event_csv', nargs='?',
+                        help='.csv file to read raw events data')
+    parser.add_argument('event_descr', nargs='?',
+                        help='.json file to read events descriptions')
+    parser.add_argument('trace', help='.json file to save the trace')
+    parser.add_argument('--columnar',
+                        help='Directory with columnar capture to read instead')
+    args = parser.parse_args()
+
+    if args.columnar is not None:
+        events = ColumnarEvents.load(args.columnar)
+        event_types = events.registered_events_types
+        events = events.iter_events()
+    elif args.event_csv is not None and args.event_descr is not None:
+        events_data = EventsData([], {})
+        events_data.read_data_from_files(args.event_csv, args.event_descr)
+        event_types = events_data.registered_events_types
+        events = events_data.events
+    else:
+        parser.error('Provide .csv and .json files or columnar capture')
+
+    writer = ChromeTraceWriter(args.trace)
+    writer.set_event_types(event_types)
+    for event in events:
+        writer.append(event)
+    writer.close()
+
+
+if __name__ == "__main__":
+    main()
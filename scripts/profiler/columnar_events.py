@@ -0,0 +1,218 @@
+# Copyright (c) 2019 Nordic Semiconductor ASA
+# SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+
+from events import Event, EventType, EventsData
+import numpy as np
+import json
+import os
+
+
+# Capture is a directory with one raw little-endian file per column and
+# a json file with the column types and the event type descriptions.
+# Data fields of all events are stored one after another in the data
+# column. Every event type has a constant number of data fields, so
+# positions of the data fields are calculated when the capture is loaded.
+COLUMNS = {
+    'type_id': '<u2',
+    'timestamp': '<f8',
+    'data': '<i8',
+}
+
+META_FILENAME = 'meta.json'
+FORMAT_VERSION = 1
+
+
+def _column_filename(dirname, column):
+    return os.path.join(dirname, column + '.bin')
+
+
+def _write_meta(dirname, event_types, event_cnt):
+    meta = {
+        'version': FORMAT_VERSION,
+        'columns': COLUMNS,
+        'event_count': event_cnt,
+        'event_types': dict((k, v.serialize())
+                            for k, v in event_types.items()),
+    }
+    tmp_filename = os.path.join(dirname, META_FILENAME + '.tmp')
+    with open(tmp_filename, 'w') as f:
+        json.dump(meta, f, indent=4)
+    os.replace(tmp_filename, os.path.join(dirname, META_FILENAME))
+
+
+class ColumnarEventsWriter():
+    def __init__(self, dirname, chunk_size=65536):
+        self.dirname = dirname
+        self.chunk_size = chunk_size
+        self.event_types = {}
+        self.event_cnt = 0
+
+        os.makedirs(dirname, exist_ok=True)
+        self.files = dict((column, open(_column_filename(dirname, column),
+                                        'wb'))
+                          for column in COLUMNS)
+        self._clear_chunk()
+
+    def _clear_chunk(self):
+        self.type_ids = []
+        self.timestamps = []
+        self.data = []
+
+    def set_event_types(self, event_types):
+        # Dictionary may be extended while capturing
+        self.event_types = event_types
+
+    def append(self, event):
+        self.type_ids.append(event.type_id)
+        self.timestamps.append(event.timestamp)
+        self.data.extend(event.data)
+        if len(self.type_ids) >= self.chunk_size:
+            self.flush()
+
+    def flush(self):
+        chunk = {
+            'type_id': self.type_ids,
+            'timestamp': self.timestamps,
+            'data': self.data,
+        }
+        for column, values in chunk.items():
+            self.files[column].write(
+                np.asarray(values, dtype=COLUMNS[column]).tobytes())
+            self.files[column].flush()
+
+        self.event_cnt += len(self.type_ids)
+        self._clear_chunk()
+        # Capture stays readable if the collection is interrupted
+        _write_meta(self.dirname, self.event_types, self.event_cnt)
+
+    def close(self):
+        self.flush()
+        for f in self.files.values():
+            f.close()
+
+
+class ColumnarEvents():
+    def __init__(self, type_id, timestamp, data, event_types):
+        self.type_id = type_id
+        self.timestamp = timestamp
+        self.data = data
+        self.registered_events_types = event_types
+        self._order = None
+        self._type_bounds = None
+
+        max_type_id = max(event_types.keys(), default=0)
+        if len(type_id) > 0:
+            max_type_id = max(max_type_id, int(type_id.max()))
+        arg_cnt = np.zeros(max_type_id + 1, dtype=np.int64)
+        for k, v in event_types.items():
+            arg_cnt[k] = len(v.data_types)
+        self.data_offset = np.zeros(len(type_id), dtype=np.int64)
+        if len(type_id) > 0:
+            np.cumsum(arg_cnt[type_id[:-1]], out=self.data_offset[1:])
+        self.arg_cnt = arg_cnt
+
+    def __len__(self):
+        return len(self.type_id)
+
+    @staticmethod
+    def load(dirname, mmap=True):
+        with open(os.path.join(dirname, META_FILENAME), 'r') as f:
+            meta = json.load(f)
+
+        event_types = dict((int(k), EventType.deserialize(v))
+                           for k, v in meta['event_types'].items())
+        event_cnt = meta['event_count']
+        columns = {}
+        for column, dtype in meta['columns'].items():
+            filename = _column_filename(dirname, column)
+            if os.path.getsize(filename) == 0:
+                columns[column] = np.zeros(0, dtype=dtype)
+            elif mmap:
+                columns[column] = np.memmap(filename, dtype=dtype, mode='r')
+            else:
+                columns[column] = np.fromfile(filename, dtype=dtype)
+
+        # Data appended after the last metadata update is skipped
+        type_id = columns['type_id'][:event_cnt]
+        events = ColumnarEvents(type_id, columns['timestamp'][:event_cnt],
+                                columns['data'], event_types)
+        return events
+
+    @staticmethod
+    def from_events_data(events_data):
+        events = events_data.events
+        type_id = np.fromiter((ev.type_id for ev in events), dtype='<u2',
+                              count=len(events))
+        timestamp = np.fromiter((ev.timestamp for ev in events), dtype='<f8',
+                                count=len(events))
+        data = np.fromiter((d for ev in events for d in ev.data), dtype='<i8')
+        return ColumnarEvents(type_id, timestamp, data,
+                              events_data.registered_events_types)
+
+    def save(self, dirname):
+        writer = ColumnarEventsWriter(dirname)
+        writer.set_event_types(self.registered_events_types)
+        for column in COLUMNS:
+            writer.files[column].write(
+                np.asarray(getattr(self, column),
+                           dtype=COLUMNS[column]).tobytes())
+        writer.event_cnt = len(self)
+        writer.close()
+
+    def get_event_type_id(self, type_name):
+        for key, value in self.registered_events_types.items():
+            if type_name == value.name:
+                return key
+        return None
+
+    def _build_type_index(self):
+        # Stable sort keeps events of every type in time order
+        self._order = np.argsort(self.type_id, kind='stable')
+        sorted_ids = self.type_id[self._order]
+        type_cnt = len(self.arg_cnt)
+        self._type_bounds = np.searchsorted(sorted_ids,
+                                            np.arange(type_cnt + 1))
+
+    def indices_of_type(self, type_id):
+        if self._order is None:
+            self._build_type_index()
+        if type_id + 1 >= len(self._type_bounds):
+            return np.zeros(0, dtype=np.int64)
+        return self._order[self._type_bounds[type_id]:
+                           self._type_bounds[type_id + 1]]
+
+    def data_of(self, indices, type_id):
+        # All events of a type have the same number of data fields
+        cnt = self.arg_cnt[type_id]
+        positions = self.data_offset[indices][:, None] + np.arange(cnt)
+        return np.asarray(self.data[positions])
+
+    def events_of_type(self, type_id):
+        indices = self.indices_of_type(type_id)
+        return (np.asarray(self.timestamp[indices]),
+                self.data_of(indices, type_id))
+
+    def iter_events(self, chunk_size=65536):
+        # Converts events in chunks to limit memory usage
+        arg_cnt = self.arg_cnt.tolist()
+        for begin in range(0, len(self), chunk_size):
+            end = min(begin + chunk_size, len(self))
+            type_ids = self.type_id[begin:end].tolist()
+            timestamps = self.timestamp[begin:end].tolist()
+            offsets = self.data_offset[begin:end].tolist()
+            data_begin = offsets[0]
+            data_end = offsets[-1] + arg_cnt[type_ids[-1]]
+            data = np.asarray(self.data[data_begin:data_end]).tolist()
+            for t, ts, o in zip(type_ids, timestamps, offsets):
+                o -= data_begin
+                yield Event(t, ts, data[o:o + arg_cnt[t]])
+
+    def to_events_data(self):
+        type_ids = self.type_id.tolist()
+        timestamps = self.timestamp.tolist()
+        data = np.asarray(self.data).tolist()
+        offsets = self.data_offset.tolist()
+        arg_cnt = self.arg_cnt.tolist()
+        events = [Event(t, ts, data[o:o + arg_cnt[t]])
+                  for t, ts, o in zip(type_ids, timestamps, offsets)]
+        return EventsData(events, self.registered_events_types)
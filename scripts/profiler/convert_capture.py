@@ -0,0 +1,29 @@
+# Copyright (c) 2019 Nordic Semiconductor ASA
+# SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+
+from events import EventsData
+from columnar_events import ColumnarEvents
+import argparse
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Converting events between .csv/.json files and columnar capture.')
+    parser.add_argument('event_csv', help='.csv file with events')
+    parser.add_argument('event_descr', help='.json file with events descriptions')
+    parser.add_argument('columnar', help='Directory with columnar capture')
+    parser.add_argument('--to_csv', action='store_true',
+                        help='Convert columnar capture to .csv/.json files')
+    args = parser.parse_args()
+
+    if args.to_csv:
+        events_data = ColumnarEvents.load(args.columnar).to_events_data()
+        events_data.write_data_to_files(args.event_csv, args.event_descr)
+    else:
+        events_data = EventsData([], {})
+        events_data.read_data_from_files(args.event_csv, args.event_descr)
+        ColumnarEvents.from_events_data(events_data).save(args.columnar)
+
+
+if __name__ == "__main__":
+    main()
@@ -2,6 +2,7 @@
 # SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
 
 from rtt_nordic_profiler_host import RttNordicProfilerHost
+from rtt_nordic_config import RttNordicConfig
 import sys
 import argparse
 import logging
@@ -13,11 +14,34 @@ def main():
     parser = argparse.ArgumentParser(
         description='Collecting data from Nordic profiler for given time and saving to files.')
     parser.add_argument('time', type=int, help='Time of collecting data [s]')
-    parser.add_argument('event_csv', help='.csv file to save collected events')
-    parser.add_argument('event_descr', help='.json file to save events descriptions')
+    parser.add_argument('event_csv', nargs='?',
+                        help='.csv file to save collected events')
+    parser.add_argument('event_descr', nargs='?',
+                        help='.json file to save events descriptions')
+    parser.add_argument('--columnar',
+                        help='Directory to save collected events in columnar '
+                        'format while collecting')
+    parser.add_argument('--chrome_trace',
+                        help='.json file to save collected events in Chrome '
+                        'trace format while collecting')
     parser.add_argument('--log', help='Log level')
+    parser.add_argument('--transport',
+                        choices=['rtt', 'uart', 'file', 'replay'],
+                        help='Transport used to connect to the device '
+                        '(replay reads recorded files)')
+    parser.add_argument('--sampling', action='store_true',
+                        help='Collect program counter samples')
     args = parser.parse_args()
 
+    if args.columnar is None and args.chrome_trace is None and \
+       (args.event_csv is None or args.event_descr is None):
+        parser.error('Provide .csv and .json files, columnar directory '
+                     'or Chrome trace file')
+
+    config = dict(RttNordicConfig)
+    if args.transport is not None:
+        config['transport'] = args.transport
+
     if args.log is not None:
 	    log_lvl_number = int(getattr(logging, args.log.upper(), None))
     else:
@@ -29,11 +53,16 @@ def main():
     signal.signal(signal.SIGINT, sigint_handler)
     end_ev = threading.Event()
 
-    profiler = RttNordicProfilerHost(event_filename=args.event_csv,
+    profiler = RttNordicProfilerHost(config=config,
+                                     event_filename=args.event_csv,
                                      finish_event=end_ev,
                                      event_types_filename=args.event_descr,
+                                     columnar_dirname=args.columnar,
+                                     trace_filename=args.chrome_trace,
                                      log_lvl=log_lvl_number)
     profiler.get_events_descriptions()
+    if args.sampling:
+        profiler.start_sampling()
     profiler.read_events_rtt(args.time)
 
 if __name__ == "__main__":
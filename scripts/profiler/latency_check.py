@@ -0,0 +1,243 @@
+# Copyright (c) 2019 Nordic Semiconductor ASA
+# SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+
+from rtt_nordic_profiler_host import RttNordicProfilerHost
+from rtt_nordic_config import RttNordicConfig
+from columnar_events import ColumnarEvents
+from latency_stats import LatencyEngine, load_events
+import numpy as np
+import argparse
+import json
+import logging
+import operator
+import re
+import sys
+
+
+# Exit codes, argparse exits with 2 on usage errors
+EXIT_PASSED = 0
+EXIT_FAILED = 1
+EXIT_NO_DATA = 3
+
+OPERATORS = {
+    '<': operator.lt,
+    '<=': operator.le,
+    '>': operator.gt,
+    '>=': operator.ge,
+}
+
+UNITS = {
+    's': 1000,
+    'ms': 1,
+    'us': 0.001,
+}
+
+# Assertions are written as:
+#   <stat> of <event> [<state>] to <event> [<state>] <op> <value> [<unit>]
+#   <stat> of <event> (queue|processing|total) <op> <value> [<unit>]
+# where stat is count, min, max, mean, std, median or pN (percentile), and
+# state is submit (default), start or end of the event processing.
+ASSERTION_RE = re.compile(
+    r'^\s*(?P<stat>count|min|max|mean|std|median|p\d+(?:\.\d+)?)\s+of\s+'
+    r'(?P<start>\w+)(?:\s+(?P<start_state>submit|start|end))?\s+'
+    r'(?:to\s+(?P<end>\w+)(?:\s+(?P<end_state>submit|start|end))?'
+    r'|(?P<metric>queue|processing|total))\s*'
+    r'(?P<op><=|>=|<|>)\s*(?P<value>[-+]?\d+(?:\.\d*)?(?:[eE][-+]?\d+)?)'
+    r'\s*(?P<unit>s|ms|us)?\s*$')
+
+
+class Assertion():
+    def __init__(self, text):
+        match = ASSERTION_RE.match(text)
+        if match is None:
+            raise ValueError('Invalid assertion: ' + text)
+
+        self.text = text.strip()
+        self.stat = match.group('stat')
+        self.start = match.group('start')
+        self.start_state = match.group('start_state') or 'submit'
+        self.end = match.group('end')
+        self.end_state = match.group('end_state') or 'submit'
+        self.metric = match.group('metric')
+        self.op = match.group('op')
+        self.limit = float(match.group('value'))
+        if self.stat != 'count':
+            self.limit *= UNITS[match.group('unit') or 'ms']
+
+    def _samples(self, engine):
+        start_id = engine.events.get_event_type_id(self.start)
+        if start_id is None:
+            raise KeyError('Event not found: ' + self.start)
+
+        if self.metric is None:
+            end_id = engine.events.get_event_type_id(self.end)
+            if end_id is None:
+                raise KeyError('Event not found: ' + self.end)
+            return engine.time_between(start_id, self.start_state,
+                                       end_id, self.end_state)
+
+        mask = (engine.submit_type == start_id) & engine.processed_mask()
+        submit = engine.submit_time[mask]
+        start = engine.start_time[mask]
+        end = engine.end_time[mask]
+        return {
+            'queue': start - submit,
+            'processing': end - start,
+            'total': end - submit,
+        }[self.metric] * 1000
+
+    def _statistic(self, samples):
+        if self.stat == 'count':
+            return len(samples)
+        if len(samples) == 0:
+            return None
+        if self.stat == 'median':
+            return float(np.median(samples))
+        if self.stat[0] == 'p':
+            return float(np.percentile(samples, float(self.stat[1:])))
+        return float(getattr(np, self.stat)(samples))
+
+    def evaluate(self, engine):
+        """Returns measured value (in milliseconds or count) and result.
+        Measured value is None if there are no samples.
+        """
+        value = self._statistic(self._samples(engine))
+        if value is None:
+            return None, False
+        return value, OPERATORS[self.op](value, self.limit)
+
+
+def read_assertions(filename):
+    # One assertion per line, lines starting with # are comments
+    with open(filename, 'r') as f:
+        return [line for line in f
+                if line.strip() and not line.lstrip().startswith('#')]
+
+
+def capture_events(args, config, log_lvl):
+    if args.recording is not None:
+        config['transport'] = 'replay'
+        config['file_data_path'], config['file_info_path'] = args.recording
+    else:
+        config['transport'] = args.transport
+        if args.data_path is not None:
+            config['file_data_path'] = args.data_path
+        if args.info_path is not None:
+            config['file_info_path'] = args.info_path
+        if args.command_path is not None:
+            config['file_command_path'] = args.command_path
+
+    if args.protocol is not None:
+        config['protocol_version'] = args.protocol
+
+    profiler = RttNordicProfilerHost(config=config, log_lvl=log_lvl)
+    profiler.get_events_descriptions()
+    if args.recording is not None:
+        # Recorded stream is read to the end when connection is closed
+        profiler.shutdown()
+    else:
+        profiler.collect_events(args.live)
+
+    return ColumnarEvents.from_events_data(profiler.received_events)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Checking latency of Event Manager events without GUI. '
+        'Exits with non-zero code if any assertion fails.')
+    parser.add_argument('event_csv', nargs='?',
+                        help='.csv file to read raw events data')
+    parser.add_argument('event_descr', nargs='?',
+                        help='.json file to read events descriptions')
+    parser.add_argument('--columnar',
+                        help='Directory with columnar capture to read instead')
+    parser.add_argument('--recording', nargs=2, metavar=('DATA', 'INFO'),
+                        help='Recorded data stream and events descriptions '
+                        '(e.g. files written by native_posix)')
+    parser.add_argument('--live', type=float, metavar='TIME',
+                        help='Collect events from device for given time [s]')
+    parser.add_argument('--transport', choices=['rtt', 'uart', 'file'],
+                        default='file',
+                        help='Transport used with --live (default: file, '
+                        'for native_posix named pipes)')
+    parser.add_argument('--data_path', help='Data file or pipe path')
+    parser.add_argument('--info_path', help='Info file or pipe path')
+    parser.add_argument('--command_path', help='Command file or pipe path')
+    parser.add_argument('--protocol', type=int, choices=[1, 2],
+                        help='Protocol version (of the recording)')
+    parser.add_argument('--assert', dest='assertions', action='append',
+                        default=[], metavar='ASSERTION',
+                        help='e.g. "p99 of motion_event submit to '
+                        'hid_report_event < 2 ms"')
+    parser.add_argument('--assertions', dest='assertions_file',
+                        help='File with one assertion per line')
+    parser.add_argument('--report', help='.json file to save results')
+    parser.add_argument('--log', help='Log level')
+    args = parser.parse_args()
+
+    sources = [args.columnar is not None, args.recording is not None,
+               args.live is not None, args.event_csv is not None]
+    if sources.count(True) != 1:
+        parser.error('Provide exactly one input: .csv and .json files, '
+                     '--columnar, --recording or --live')
+    if args.event_csv is not None and args.event_descr is None:
+        parser.error('Provide .json file with events descriptions')
+
+    texts = list(args.assertions)
+    if args.assertions_file is not None:
+        texts += read_assertions(args.assertions_file)
+    if len(texts) == 0:
+        parser.error('No assertions given')
+    try:
+        assertions = [Assertion(t) for t in texts]
+    except ValueError as e:
+        parser.error(str(e))
+
+    if args.log is not None:
+        log_lvl_number = int(getattr(logging, args.log.upper(), None))
+    else:
+        log_lvl_number = logging.WARNING
+
+    if args.columnar is not None or args.event_csv is not None:
+        events = load_events(args)
+    else:
+        events = capture_events(args, dict(RttNordicConfig), log_lvl_number)
+
+    if len(events) == 0:
+        print("No events received")
+        sys.exit(EXIT_NO_DATA)
+
+    engine = LatencyEngine(events, log_lvl_number)
+
+    exit_code = EXIT_PASSED
+    results = []
+    for a in assertions:
+        try:
+            value, passed = a.evaluate(engine)
+        except KeyError as e:
+            value, passed = None, False
+            print("ERROR {}: {}".format(a.text, e.args[0]))
+        else:
+            if value is None:
+                measured = "no samples"
+            elif a.stat == 'count':
+                measured = str(value)
+            else:
+                measured = "{:.3f} ms".format(value)
+            print("{} {} (measured: {})".format("PASS" if passed else "FAIL",
+                                                a.text, measured))
+        if not passed:
+            exit_code = EXIT_FAILED
+        results.append({'assertion': a.text, 'value': value,
+                        'passed': passed})
+
+    if args.report is not None:
+        with open(args.report, 'w') as f:
+            json.dump({'passed': exit_code == EXIT_PASSED,
+                       'results': results}, f, indent=4)
+
+    sys.exit(exit_code)
+
+
+if __name__ == "__main__":
+    main()
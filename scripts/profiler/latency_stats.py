@@ -0,0 +1,341 @@
+# Copyright (c) 2019 Nordic Semiconductor ASA
+# SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+
+from columnar_events import ColumnarEvents
+from events import EventsData
+import numpy as np
+import argparse
+import csv
+import json
+import logging
+import sys
+
+
+PERCENTILES = (50, 90, 99, 99.9)
+
+START_EVENT_NAME = 'event_processing_start'
+END_EVENT_NAME = 'event_processing_end'
+MEM_ADDRESS_LABEL = 'mem_address'
+
+STATES = ('submit', 'start', 'end')
+
+
+def _join_keys(keys, times, ref_keys, ref_times):
+    # Composite key orders by memory address first and time second. Ranks
+    # keep the key exact and small for any timestamp values.
+    _, key_idx = np.unique(np.concatenate([keys, ref_keys]),
+                           return_inverse=True)
+    _, time_idx = np.unique(np.concatenate([times, ref_times]),
+                            return_inverse=True)
+    composite = key_idx.astype(np.int64) * (time_idx.max(initial=0) + 1) + \
+                time_idx
+    return composite[:len(keys)], composite[len(keys):]
+
+
+def match_last_before(keys, times, ref_keys, ref_times):
+    """For every reference, find the last item with the same key and time
+    not later than the reference time. Returns the item index or -1.
+    """
+    if len(keys) == 0 or len(ref_keys) == 0:
+        return np.full(len(ref_keys), -1, dtype=np.int64)
+
+    item_comp, ref_comp = _join_keys(keys, times, ref_keys, ref_times)
+    order = np.argsort(item_comp, kind='stable')
+    pos = np.searchsorted(item_comp[order], ref_comp, side='right') - 1
+    found = order[np.maximum(pos, 0)]
+    valid = (pos >= 0) & (keys[found] == ref_keys)
+    return np.where(valid, found, -1)
+
+
+def match_first_after(keys, times, ref_keys, ref_times):
+    """For every reference, find the first item with the same key and time
+    not earlier than the reference time. Returns the item index or -1.
+    """
+    if len(keys) == 0 or len(ref_keys) == 0:
+        return np.full(len(ref_keys), -1, dtype=np.int64)
+
+    item_comp, ref_comp = _join_keys(keys, times, ref_keys, ref_times)
+    order = np.argsort(item_comp, kind='stable')
+    pos = np.searchsorted(item_comp[order], ref_comp, side='left')
+    found = order[np.minimum(pos, len(order) - 1)]
+    valid = (pos < len(order)) & (keys[found] == ref_keys)
+    return np.where(valid, found, -1)
+
+
+def summarize(times_ms, hist_bin_cnt=None):
+    summary = {'count': int(len(times_ms))}
+    if len(times_ms) == 0:
+        return summary
+
+    summary['min'] = float(np.min(times_ms))
+    summary['max'] = float(np.max(times_ms))
+    summary['mean'] = float(np.mean(times_ms))
+    summary['std'] = float(np.std(times_ms))
+    for p, val in zip(PERCENTILES, np.percentile(times_ms, PERCENTILES)):
+        summary['p{}'.format(p)] = float(val)
+
+    if hist_bin_cnt is not None:
+        counts, edges = np.histogram(times_ms, bins=hist_bin_cnt)
+        summary['histogram'] = {'edges': edges.tolist(),
+                                'counts': counts.tolist()}
+    return summary
+
+
+class LatencyEngine():
+    def __init__(self, events, log_lvl=logging.WARNING):
+        self.events = events
+        self.logger = logging.getLogger('Latency Stats')
+        self.logger_console = logging.StreamHandler()
+        self.logger.setLevel(log_lvl)
+        self.log_format = logging.Formatter(
+            '[%(levelname)s] %(name)s: %(message)s')
+        self.logger_console.setFormatter(self.log_format)
+        self.logger.addHandler(self.logger_console)
+
+        self.start_id = events.get_event_type_id(START_EVENT_NAME)
+        self.end_id = events.get_event_type_id(END_EVENT_NAME)
+        self.tracking_execution = (self.start_id is not None) and \
+                                  (self.end_id is not None)
+        self._match_processing()
+
+    @staticmethod
+    def from_events_data(events_data, log_lvl=logging.WARNING):
+        return LatencyEngine(ColumnarEvents.from_events_data(events_data),
+                             log_lvl)
+
+    def _submit_types(self):
+        skip = (self.start_id, self.end_id)
+        return [k for k, v in self.events.registered_events_types.items()
+                if k not in skip and len(v.data_descriptions) > 0 and
+                v.data_descriptions[0] == MEM_ADDRESS_LABEL]
+
+    def _first_field(self, type_id):
+        idx = self.events.indices_of_type(type_id)
+        times = np.asarray(self.events.timestamp[idx])
+        if len(idx) == 0:
+            return idx, times, np.zeros(0, dtype=np.int64)
+        return idx, times, self.events.data_of(idx, type_id)[:, 0]
+
+    def _match_processing(self):
+        """Join submissions, processing starts and ends of the events on the
+        memory address of the event and time.
+        """
+        indices = []
+        types = []
+        times = []
+        addrs = []
+        for type_id in self._submit_types():
+            idx, t, addr = self._first_field(type_id)
+            indices.append(idx)
+            types.append(np.full(len(t), type_id, dtype=np.int64))
+            times.append(t)
+            addrs.append(addr)
+
+        if len(times) > 0:
+            order = np.argsort(np.concatenate(indices), kind='stable')
+            # Index of the submission in the capture
+            self.submit_index = np.concatenate(indices)[order]
+            self.submit_type = np.concatenate(types)[order]
+            self.submit_time = np.concatenate(times)[order]
+            submit_addr = np.concatenate(addrs)[order]
+        else:
+            self.submit_index = np.zeros(0, dtype=np.int64)
+            self.submit_type = np.zeros(0, dtype=np.int64)
+            self.submit_time = np.zeros(0)
+            submit_addr = np.zeros(0, dtype=np.int64)
+
+        self.start_time = np.full(len(self.submit_time), np.nan)
+        self.end_time = np.full(len(self.submit_time), np.nan)
+
+        if not self.tracking_execution:
+            return
+
+        _, start_t, start_addr = self._first_field(self.start_id)
+        _, end_t, end_addr = self._first_field(self.end_id)
+
+        # Memory of an event can be reused after the event is processed, so
+        # the processing is matched with the last submission before it.
+        submit_idx = match_last_before(submit_addr, self.submit_time,
+                                       start_addr, start_t)
+        end_idx = match_first_after(end_addr, end_t, start_addr, start_t)
+
+        valid = submit_idx >= 0
+        self.start_time[submit_idx[valid]] = start_t[valid]
+        valid &= end_idx >= 0
+        self.end_time[submit_idx[valid]] = end_t[end_idx[valid]]
+
+        unmatched = np.count_nonzero(submit_idx < 0)
+        if unmatched > 0:
+            self.logger.warning("{} processing starts without submission"
+                                .format(unmatched))
+
+    def processed_mask(self):
+        return ~np.isnan(self.end_time)
+
+    def state_times(self, type_id, state):
+        if state not in STATES:
+            raise ValueError('Unknown event state: ' + state)
+
+        if state != 'submit' and not self.tracking_execution:
+            self.logger.error("Events processing is not tracked")
+            return np.zeros(0)
+
+        if type_id in self._submit_types():
+            mask = self.submit_type == type_id
+            times = {'submit': self.submit_time,
+                     'start': self.start_time,
+                     'end': self.end_time}[state][mask]
+            return times[~np.isnan(times)]
+
+        if state != 'submit':
+            self.logger.error("Processing of event type {} is not tracked"
+                              .format(type_id))
+            return np.zeros(0)
+
+        return np.asarray(self.events.timestamp[
+                          self.events.indices_of_type(type_id)])
+
+    def time_between(self, start_type, start_state, end_type, end_state,
+                     start_meas=0, end_meas=float('inf')):
+        """Time from every start to the next end (in milliseconds)."""
+        start_times = np.sort(self.state_times(start_type, start_state))
+        end_times = np.sort(self.state_times(end_type, end_state))
+        start_times = start_times[(start_times > start_meas) &
+                                  (start_times < end_meas)]
+        end_times = end_times[(end_times > start_meas) &
+                              (end_times < end_meas)]
+
+        pos = np.searchsorted(end_times, start_times, side='right')
+        valid = pos < len(end_times)
+        return (end_times[pos[valid]] - start_times[valid]) * 1000
+
+    def latency_stats(self, hist_bin_cnt=None):
+        stats = {}
+        for type_id in np.unique(self.submit_type):
+            type_id = int(type_id)
+            mask = (self.submit_type == type_id) & self.processed_mask()
+            submit = self.submit_time[mask]
+            start = self.start_time[mask]
+            end = self.end_time[mask]
+            name = self.events.registered_events_types[type_id].name
+            stats[name] = {
+                'queue': summarize((start - submit) * 1000, hist_bin_cnt),
+                'processing': summarize((end - start) * 1000, hist_bin_cnt),
+                'total': summarize((end - submit) * 1000, hist_bin_cnt),
+            }
+        return stats
+
+    def throughput(self, window, step):
+        """Submissions per second in sliding windows."""
+        if len(self.submit_time) == 0:
+            return {}
+
+        begin = np.arange(self.submit_time[0], self.submit_time[-1], step)
+        result = {'window_start': begin.tolist()}
+        for type_id in np.unique(self.submit_type):
+            times = self.submit_time[self.submit_type == type_id]
+            cnt = np.searchsorted(times, begin + window) - \
+                  np.searchsorted(times, begin)
+            name = self.events.registered_events_types[int(type_id)].name
+            result[name] = (cnt / window).tolist()
+        return result
+
+    def queue_depth(self):
+        """Number of submitted events that are not yet processed."""
+        processed = self.processed_mask()
+        times = np.concatenate([self.submit_time[processed],
+                                self.start_time[processed]])
+        deltas = np.concatenate([np.ones(np.count_nonzero(processed)),
+                                 -np.ones(np.count_nonzero(processed))])
+        # Processing start is applied before a submission at the same time
+        order = np.lexsort((deltas, times))
+        depth = np.cumsum(deltas[order])
+        return times[order], depth
+
+    def queue_depth_stats(self):
+        times, depth = self.queue_depth()
+        if len(times) < 2:
+            return {'max': 0, 'mean': 0.0}
+        durations = np.diff(times)
+        mean = np.sum(depth[:-1] * durations) / (times[-1] - times[0]) \
+            if times[-1] > times[0] else 0.0
+        return {'max': int(depth.max()), 'mean': float(mean)}
+
+
+def write_stats_csv(filename, stats):
+    columns = ['count', 'min', 'max', 'mean', 'std'] + \
+              ['p{}'.format(p) for p in PERCENTILES]
+    with open(filename, 'w', newline='') as csvfile:
+        wr = csv.writer(csvfile)
+        wr.writerow(['event', 'metric'] + columns)
+        for name, metrics in stats.items():
+            for metric, summary in metrics.items():
+                wr.writerow([name, metric] +
+                            [summary.get(c, '') for c in columns])
+
+
+def load_events(args):
+    if args.columnar is not None:
+        return ColumnarEvents.load(args.columnar)
+    events_data = EventsData([], {})
+    events_data.read_data_from_files(args.event_csv, args.event_descr)
+    return ColumnarEvents.from_events_data(events_data)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Calculating latency statistics of Event Manager events.')
+    parser.add_argument('event_csv', nargs='?',
+                        help='.csv file to read raw events data')
+    parser.add_argument('event_descr', nargs='?',
+                        help='.json file to read events descriptions')
+    parser.add_argument('--columnar',
+                        help='Directory with columnar capture to read instead')
+    parser.add_argument('--csv', help='.csv file to save latency statistics')
+    parser.add_argument('--json', help='.json file to save all statistics')
+    parser.add_argument('--hist_bins', type=int, default=100,
+                        help='Number of latency histogram bins (json only)')
+    parser.add_argument('--window', type=float, default=1.0,
+                        help='Throughput window [s]')
+    parser.add_argument('--step', type=float, default=0.1,
+                        help='Throughput window step [s]')
+    parser.add_argument('--log', help='Log level')
+    args = parser.parse_args()
+
+    if args.columnar is None and \
+       (args.event_csv is None or args.event_descr is None):
+        parser.error('Provide .csv and .json files or columnar capture')
+
+    if args.log is not None:
+        log_lvl_number = int(getattr(logging, args.log.upper(), None))
+    else:
+        log_lvl_number = logging.WARNING
+
+    engine = LatencyEngine(load_events(args), log_lvl_number)
+    stats = engine.latency_stats()
+
+    for name, metrics in stats.items():
+        total = metrics['total']
+        if total['count'] == 0:
+            continue
+        print("{}: {} events, total latency p50 {:.3f} ms, p99 {:.3f} ms"
+              .format(name, total['count'], total['p50'], total['p99']))
+
+    if args.csv is not None:
+        write_stats_csv(args.csv, stats)
+
+    if args.json is not None:
+        times, depth = engine.queue_depth()
+        result = {
+            'latency': engine.latency_stats(args.hist_bins),
+            'throughput': engine.throughput(args.window, args.step),
+            'queue_depth': dict(engine.queue_depth_stats(),
+                                timeline={'time': times.tolist(),
+                                          'depth': depth.tolist()}),
+        }
+        with open(args.json, 'w') as f:
+            json.dump(result, f, indent=4)
+
+
+if __name__ == "__main__":
+    main()
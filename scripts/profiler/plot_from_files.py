@@ -10,21 +10,30 @@ def main():
     parser = argparse.ArgumentParser(
         description='Plotting events from given files.')
     parser.add_argument(
-        'event_csv',
+        'event_csv', nargs='?',
         help='.csv file to save collected events')
     parser.add_argument(
-        'event_descr',
+        'event_descr', nargs='?',
         help='.json file to save events descriptions')
+    parser.add_argument('--columnar',
+                        help='Directory with columnar capture to read instead')
     parser.add_argument('--log', help='Log level')
     args = parser.parse_args()
 
+    if args.columnar is None and \
+       (args.event_csv is None or args.event_descr is None):
+        parser.error('Provide .csv and .json files or columnar capture')
+
     if args.log is not None:
 	    log_lvl_number = int(getattr(logging, args.log.upper(), None))
     else:
 	    log_lvl_number = logging.WARNING
 
     pn = PlotNordic(log_lvl=log_lvl_number)
-    pn.read_data_from_files(args.event_csv, args.event_descr)
+    if args.columnar is not None:
+        pn.read_data_from_columnar(args.columnar)
+    else:
+        pn.read_data_from_files(args.event_csv, args.event_descr)
     pn.plot_events_from_file()
     pn.log_stats('log')
 
@@ -1,4 +1,5 @@
 from events import EventsData, TrackedEvent
+from latency_stats import LatencyEngine
 import logging
 import sys
 
@@ -10,6 +11,7 @@ class ProcessedEvents():
         self.event_processing_start_id = None
         self.event_processing_end_id = None
         self.tracking_execution = True
+        self.engine = None
 
         self.submit_event = None
         self.start_event = None
@@ -35,24 +37,14 @@ class ProcessedEvents():
                 self.tracked_events.append(TrackedEvent(ev, None, None))
             return
 
-        for i in range(1, len(self.raw_data.events)):
-            if self.raw_data.events[i].type_id == self.event_processing_start_id:
-                self.start_event = self.raw_data.events[i]
-                for j in range(i - 1, -1, -1):
-                    # comparing memory addresses of event processing start
-                    # and event submit to identify matching events
-                    if self.raw_data.events[j].data[0] == self.start_event.data[0]:
-                        self.submit_event = self.raw_data.events[j]
-                        break
-
-            # comparing memory addresses of event processing start and end
-            # to identify matching events
-            if self.raw_data.events[i].type_id == self.event_processing_end_id:
-                if self.submit_event is not None \
-                        and self.raw_data.events[i].data[0] == self.start_event.data[0]:
-                    self.tracked_events.append(
-                        TrackedEvent(
-                            self.submit_event,
-                            self.start_event.timestamp,
-                            self.raw_data.events[i].timestamp))
-                    self.submit_event = None
+        # Submissions and processing are joined on the memory address
+        # of the event
+        self.engine = LatencyEngine.from_events_data(self.raw_data)
+        processed = self.engine.processed_mask()
+        events = self.raw_data.events
+        self.tracked_events = [
+            TrackedEvent(events[i], start, end)
+            for i, start, end in zip(
+                self.engine.submit_index[processed].tolist(),
+                self.engine.start_time[processed].tolist(),
+                self.engine.end_time[processed].tolist())]
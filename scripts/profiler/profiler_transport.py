@@ -0,0 +1,195 @@
+# Copyright (c) 2019 Nordic Semiconductor ASA
+# SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+
+import os
+import stat
+import time
+from enum import Enum
+
+
+class Channel(Enum):
+    DATA = 0
+    INFO = 1
+
+
+class RttTransport:
+    """Profiler channels mapped to separate RTT channels."""
+
+    def __init__(self, config, logger):
+        self.config = config
+        self.logger = logger
+        self.channels = {
+            Channel.DATA: config['rtt_data_channel'],
+            Channel.INFO: config['rtt_info_channel'],
+        }
+
+    def _get_device_family(self, api_module):
+        with api_module.API(api_module.DeviceFamily.UNKNOWN) as api:
+            api.connect_to_emu_without_snr()
+            return api.read_device_family()
+
+    def connect(self):
+        from pynrfjprog import API
+
+        try:
+            self.jlink = API.API(self.config['device_family'])
+        except ValueError:
+            self.logger.warning('Unrecognized device family. Trying to recognize automatically')
+            self.config['device_family'] = self._get_device_family(API)
+            self.logger.info('Recognized device family: ' + self.config['device_family'])
+            self.jlink = API.API(self.config['device_family'])
+
+        self.jlink.open()
+        if self.config['device_snr'] is not None:
+            self.jlink.connect_to_emu_with_snr(self.config['device_snr'])
+        else:
+            self.jlink.connect_to_emu_without_snr()
+
+        if self.config['reset_on_start']:
+            self.jlink.sys_reset()
+            self.jlink.go()
+        self.jlink.rtt_start()
+        time.sleep(1)  # time required for initialization
+        self.logger.info("Connected to device via RTT")
+
+    def disconnect(self):
+        self.jlink.rtt_stop()
+        self.jlink.disconnect_from_emu()
+        self.jlink.close()
+
+    def read(self, channel, size):
+        return bytes(self.jlink.rtt_read(self.channels[channel], size,
+                                         encoding=None))
+
+    def write_command(self, command):
+        self.jlink.rtt_write(self.config['rtt_command_channel'], command,
+                             None)
+
+
+class UartTransport:
+    """Profiler channels multiplexed on UART.
+
+    Every chunk of data is preceded by a header with the channel ID and
+    the length of the data.
+    """
+
+    HEADER_SIZE = 2
+
+    def __init__(self, config, logger):
+        self.config = config
+        self.logger = logger
+        self.rx_buf = bytearray()
+        self.bufs = {channel: bytearray() for channel in Channel}
+
+    def connect(self):
+        import serial
+
+        self.serial = serial.Serial(self.config['uart_port'],
+                                    self.config['uart_baudrate'],
+                                    timeout=0)
+        self.logger.info("Connected to device via UART")
+
+    def disconnect(self):
+        self.serial.close()
+
+    def _demultiplex(self):
+        self.rx_buf += self.serial.read(self.config['rtt_read_chunk_size'])
+
+        while len(self.rx_buf) >= self.HEADER_SIZE:
+            channel = Channel(self.rx_buf[0])
+            size = self.rx_buf[1]
+            if len(self.rx_buf) < self.HEADER_SIZE + size:
+                break
+            self.bufs[channel] += self.rx_buf[self.HEADER_SIZE:self.HEADER_SIZE + size]
+            del self.rx_buf[0:self.HEADER_SIZE + size]
+
+    def read(self, channel, size):
+        self._demultiplex()
+        buf = bytes(self.bufs[channel][0:size])
+        del self.bufs[channel][0:size]
+        return buf
+
+    def write_command(self, command):
+        self.serial.write(command)
+
+
+class FileTransport:
+    """Profiler channels written to files or named pipes (native_posix)."""
+
+    def __init__(self, config, logger):
+        self.config = config
+        self.logger = logger
+        self.paths = {
+            Channel.DATA: config['file_data_path'],
+            Channel.INFO: config['file_info_path'],
+        }
+
+    def connect(self):
+        # Command pipe is opened first, the application opens it when
+        # the profiler is initialized. Commands left in a regular file by
+        # an earlier session are discarded.
+        command_path = self.config['file_command_path']
+        flags = os.O_RDWR | os.O_CREAT
+        if not os.path.exists(command_path) or \
+                stat.S_ISREG(os.stat(command_path).st_mode):
+            flags |= os.O_TRUNC
+        self.command_fd = os.open(command_path, flags)
+        self.fds = {channel: os.open(path, os.O_RDONLY | os.O_NONBLOCK)
+                    for channel, path in self.paths.items()}
+        self.logger.info("Connected to device via files")
+
+    def disconnect(self):
+        for fd in self.fds.values():
+            os.close(fd)
+        os.close(self.command_fd)
+
+    def read(self, channel, size):
+        try:
+            return os.read(self.fds[channel], size)
+        except BlockingIOError:
+            return bytes()
+
+    def write_command(self, command):
+        os.write(self.command_fd, command)
+
+
+class ReplayTransport:
+    """Profiler channels read from files recorded earlier.
+
+    Commands are not sent, data is read until the end of the files.
+    """
+
+    def __init__(self, config, logger):
+        self.config = config
+        self.logger = logger
+        self.paths = {
+            Channel.DATA: config['file_data_path'],
+            Channel.INFO: config['file_info_path'],
+        }
+
+    def connect(self):
+        self.files = {channel: open(path, 'rb')
+                      for channel, path in self.paths.items()}
+        self.logger.info("Replaying recorded data")
+
+    def disconnect(self):
+        for f in self.files.values():
+            f.close()
+
+    def read(self, channel, size):
+        return self.files[channel].read(size)
+
+    def write_command(self, command):
+        self.logger.debug("Command ignored during replay")
+
+
+TRANSPORTS = {
+    'rtt': RttTransport,
+    'uart': UartTransport,
+    'file': FileTransport,
+    'replay': ReplayTransport,
+}
+
+
+def create_transport(config, logger):
+    return TRANSPORTS[config['transport']](config, logger)
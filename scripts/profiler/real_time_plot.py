@@ -3,6 +3,7 @@
 
 from plot_nordic import PlotNordic
 from rtt_nordic_profiler_host import RttNordicProfilerHost
+from rtt_nordic_config import RttNordicConfig
 
 import argparse
 import threading
@@ -10,8 +11,9 @@ import queue
 import sys
 import logging
 
-def rtt_thread(queue, finish_event, event_filename, event_types_filename, log_lvl_number):
-    profiler = RttNordicProfilerHost(finish_event=finish_event, queue=queue,
+def rtt_thread(queue, finish_event, event_filename, event_types_filename, log_lvl_number, config):
+    profiler = RttNordicProfilerHost(config=config,
+                                     finish_event=finish_event, queue=queue,
                                      event_filename=event_filename,
                                      event_types_filename=event_types_filename,
                                      log_lvl=log_lvl_number)
@@ -26,8 +28,14 @@ def main():
         'event_descr',
         help='.json file to save events descriptions')
     parser.add_argument('--log', help='Log level')
+    parser.add_argument('--transport', choices=['rtt', 'uart', 'file'],
+                        help='Transport used to connect to the device')
     args = parser.parse_args()
 
+    config = dict(RttNordicConfig)
+    if args.transport is not None:
+        config['transport'] = args.transport
+
     if args.log is not None:
         log_lvl_number = int(getattr(logging, args.log.upper(), None))
     else:
@@ -37,7 +45,7 @@ def main():
     que = queue.Queue()
     t_rtt = threading.Thread(
         target=rtt_thread,
-        args=[que, ev, args.event_csv, args.event_descr, log_lvl_number])
+        args=[que, ev, args.event_csv, args.event_descr, log_lvl_number, config])
     t_rtt.start()
 
     pn = PlotNordic(log_lvl=log_lvl_number)
@@ -2,6 +2,7 @@
 # SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
 
 RttNordicConfig = {
+    'transport': 'rtt', # 'rtt', 'uart', 'file' or 'replay'
     'device_family': 'NRF52',
     'device_snr' : None,
     'rtt_info_channel': 2,
@@ -12,7 +13,15 @@ RttNordicConfig = {
     'reset_on_start': True,
     'connection_timeout': -1,
     'timestamp_raw_max': 2**32, #timestamp on uC is stored as 32-bit value
+    'protocol_version': 2, # highest protocol version requested from device
+    'info_timeout': 2, # in seconds, fall back to version 1 after timeout
+    'read_timeout': 1, # in seconds, waiting for the rest of an event after collection time
     'rtt_read_period': 0.1, #in seconds
     'rtt_read_chunk_size': 64000,
-    'rtt_additional_read_thresh': 4096
+    'rtt_additional_read_thresh': 4096,
+    'uart_port': '/dev/ttyACM0',
+    'uart_baudrate': 1000000,
+    'file_data_path': 'profiler_data.bin',
+    'file_info_path': 'profiler_info.txt',
+    'file_command_path': 'profiler_commands.bin'
 }
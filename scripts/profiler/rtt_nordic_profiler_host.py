@@ -1,43 +1,77 @@
 # Copyright (c) 2018 Nordic Semiconductor ASA
 # SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
 
-from pynrfjprog import API
 import time
-import matplotlib.pyplot as plt
 from datetime import datetime
 import queue
 import sys
 import threading
 from enum import Enum
 from rtt_nordic_config import RttNordicConfig
+from profiler_transport import Channel, create_transport
 from events import Event, EventType, EventsData
+from columnar_events import ColumnarEventsWriter
+from chrome_trace import ChromeTraceWriter
 import logging
 
 class Command(Enum):
     START = 1
     STOP = 2
     INFO = 3
+    INFO_V2 = 4
+    SAMPLING_START = 5
+    SAMPLING_STOP = 6
+    SAMPLING_DUMP = 7
 
 
 class RttNordicProfilerHost:
 
+    # Contexts reported by the profiler_drop event
+    DROP_CONTEXTS = {0: 'thread', 1: 'ISR', 2: 'transport'}
+
+    # Protocol version 2 records with special meaning of ID byte
+    DESCRIPTION_ID = 0xFD
+    ESCAPE_ID = 0xFE
+    EPOCH_MARKER_ID = 0xFF
+
+    # Sizes of event data values in protocol version 2
+    ARG_SIZES = {'u8': 1, 's8': 1, 'u16': 2, 's16': 2}
+
     def __init__(self, config=RttNordicConfig, finish_event=None,
                  queue=None, event_filename=None,
-                 event_types_filename=None, log_lvl=logging.WARNING):
+                 event_types_filename=None, columnar_dirname=None,
+                 trace_filename=None, log_lvl=logging.WARNING):
         self.event_filename = event_filename
         self.event_types_filename = event_types_filename
         self.config = config
         self.finish_event = finish_event
         self.queue = queue
         self.received_events = EventsData([], {})
+        self.columnar_writer = None
+        if columnar_dirname is not None:
+            # Events are appended to files in chunks instead of being kept
+            # in memory
+            self.columnar_writer = ColumnarEventsWriter(columnar_dirname)
+            self.columnar_writer.set_event_types(
+                self.received_events.registered_events_types)
+        self.trace_writer = None
+        if trace_filename is not None:
+            # Chrome trace is written while receiving events
+            self.trace_writer = ChromeTraceWriter(trace_filename)
+            self.trace_writer.set_event_types(
+                self.received_events.registered_events_types)
         self.timestamp_overflows = 0
         self.after_half = False
+        self.protocol_version = 1
+        self.timestamp_abs = 0
+        self.sampling = False
 
         self.desc_buf = ""
         self.bufs = list()
         self.bcnt = 0
         self.last_read_time = time.time()
         self.reading_data = True
+        self.read_deadline = None
 
         self.logger = logging.getLogger('RTT Profiler Host')
         self.logger_console = logging.StreamHandler()
@@ -48,47 +82,29 @@ class RttNordicProfilerHost:
 
         self.connect()
 
-    def rtt_get_device_family():
-        with API.API(API.DeviceFamily.UNKNOWN) as api:
-            api.connect_to_emu_without_snr()
-            return api.read_device_family()
-
     def connect(self):
-        try:
-            self.jlink = API.API(self.config['device_family'])
-        except ValueError:
-            self.logger.warning('Unrecognized device family. Trying to recognize automatically')
-            self.config['device_family'] = rtt_nordic_profiler_host.rtt_get_device_family()
-            self.logger.info('Recognized device family: ' + self.config['device_family'])
-            self.jlink = API.API(self.config['device_family'])
-
-        self.jlink.open()
-        if self.config['device_snr'] is not None:
-            self.jlink.connect_to_emu_with_snr(self.config['device_snr'])
-        else:
-            self.jlink.connect_to_emu_without_snr()
-
-        if self.config['reset_on_start']:
-            self.jlink.sys_reset()
-            self.jlink.go()
-        self.jlink.rtt_start()
-        time.sleep(1)  # time required for initialization
-        self.logger.info("Connected to device via RTT")
+        self.transport = create_transport(self.config, self.logger)
+        self.transport.connect()
 
     def shutdown(self):
         self.disconnect()
         self._read_remaining_events()
+        if self.columnar_writer is not None:
+            self.columnar_writer.close()
+        if self.trace_writer is not None:
+            self.trace_writer.close()
         if self.event_filename and self.event_types_filename:
             self.received_events.write_data_to_files(self.event_filename,
                                                      self.event_types_filename)
 
     def disconnect(self):
+        if self.sampling:
+            self.stop_sampling()
         self.stop_logging_events()
         # read remaining data to buffer
         try:
-            buf = self.jlink.rtt_read(self.config['rtt_data_channel'],
-                                      self.config['rtt_read_chunk_size'],
-                                      encoding=None)
+            buf = self.transport.read(Channel.DATA,
+                                      self.config['rtt_read_chunk_size'])
 
         except:
             self.logger.error("Problem with reading RTT data.")
@@ -96,16 +112,13 @@ class RttNordicProfilerHost:
         while len(buf) > 0:
             self.bufs.append(buf)
             self.bcnt += len(buf)
-            buf = self.jlink.rtt_read(self.config['rtt_data_channel'],
-                                      self.config['rtt_read_chunk_size'],
-                                      encoding=None)
+            buf = self.transport.read(Channel.DATA,
+                                      self.config['rtt_read_chunk_size'])
         try:
-            self.jlink.rtt_stop()
-            self.jlink.disconnect_from_emu()
-            self.jlink.close()
+            self.transport.disconnect()
 
         except:
-            self.logger.error("JLink connection lost. Saving collected data.")
+            self.logger.error("Connection lost. Saving collected data.")
             return
 
         self.logger.info("Disconnected from device")
@@ -133,9 +146,8 @@ class RttNordicProfilerHost:
                 break
 
             try:
-                buf = self.jlink.rtt_read(self.config['rtt_data_channel'],
-                                          self.config['rtt_read_chunk_size'],
-                                          encoding=None)
+                buf = self.transport.read(Channel.DATA,
+                                          self.config['rtt_read_chunk_size'])
             except:
                 self.logger.error("Problem with reading RTT data.")
                 self.shutdown()
@@ -152,6 +164,12 @@ class RttNordicProfilerHost:
             if self.bcnt >= num_bytes:
                 break
 
+            if self.read_deadline is not None and \
+               time.time() > self.read_deadline:
+                # Stop waiting for rest of the event
+                self.reading_data = False
+                break
+
             if self.finish_event is not None and self.finish_event.is_set():
                 self.finish_event.clear()
                 self.logger.info("Real time transmission closed")
@@ -167,12 +185,14 @@ class RttNordicProfilerHost:
         return self.config['ms_per_timestamp_tick'] * (
             clock_ticks + self.timestamp_overflows * self.config['timestamp_raw_max']) / 1000
 
-    def _read_single_event_description(self):
+    def _read_info_line(self, timeout=None):
+        start_time = time.time()
         while '\n' not in self.desc_buf:
+            if timeout is not None and time.time() - start_time > timeout:
+                raise TimeoutError
             try:
-                buf_temp = self.jlink.rtt_read(self.config['rtt_info_channel'],
-                                      self.config['rtt_read_chunk_size'],
-                                      encoding='utf-8')
+                buf_temp = self.transport.read(Channel.INFO,
+                                      self.config['rtt_read_chunk_size']).decode('utf-8')
 
             except:
                 self.logger.error("Problem with reading RTT data.")
@@ -181,12 +201,31 @@ class RttNordicProfilerHost:
             self.desc_buf += buf_temp
             time.sleep(0.1)
 
-        desc = str(self.desc_buf[0:self.desc_buf.find('\n')])
+        line, self.desc_buf = self.desc_buf.split('\n', 1)
+        return line
+
+    def _read_single_event_description(self, timeout=None):
+        desc = self._read_info_line(timeout)
         # Empty field is send after last event description
         if len(desc) == 0:
             return None, None
-        self.desc_buf = self.desc_buf[self.desc_buf.find('\n')+1:]
 
+        return self._parse_event_description(desc)
+
+    def _read_device_protocol_version(self, timeout):
+        # Firmware supporting version 2 advertises it after the descriptions
+        # sent for the version 1 INFO command
+        try:
+            line = self._read_info_line(timeout)
+        except TimeoutError:
+            return 1
+        fields = line.split(',')
+        if len(fields) == 2 and fields[0] == 'protocol_version':
+            return int(fields[1])
+        return 1
+
+    @staticmethod
+    def _parse_event_description(desc):
         desc_fields = desc.split(',')
 
         name = desc_fields[0]
@@ -199,26 +238,90 @@ class RttNordicProfilerHost:
             data.append(desc_fields[i])
         return id, EventType(name, data_type, data)
 
-    def _read_all_events_descriptions(self):
+    def _read_all_events_descriptions(self, timeout=None):
         while True:
-            id, et = self._read_single_event_description()
+            id, et = self._read_single_event_description(timeout)
             if (id is None or et is None):
                 break
             self.received_events.registered_events_types[id] = et
 
     def get_events_descriptions(self):
-        self._send_command(Command.INFO)
-        self._read_all_events_descriptions()
+        if self.config['transport'] == 'replay':
+            # Commands are not sent, version of the recording is configured
+            self._read_all_events_descriptions()
+            self.protocol_version = min(self.config['protocol_version'], 2)
+        else:
+            # Firmware without protocol version 2 asserts on unknown commands,
+            # so version 1 is requested first
+            self._send_command(Command.INFO)
+            self._read_all_events_descriptions()
+            device_version = self._read_device_protocol_version(
+                self.config['info_timeout'])
+            if min(device_version, self.config['protocol_version']) >= 2:
+                self._send_command(Command.INFO_V2)
+                self._read_all_events_descriptions()
+                self.protocol_version = 2
+            elif device_version < 2:
+                self.logger.info("Protocol version 2 not supported")
+
+        self.logger.info("Using protocol version {}".format(
+            self.protocol_version))
         if self.queue is not None:
             self.queue.put(self.received_events.registered_events_types)
         self.logger.info("Received events descriptions")
         self.logger.info("Ready to start logging events")
 
-    def _read_single_event_rtt(self):
-        id = int.from_bytes(
-            self._read_bytes(1),
-            byteorder=self.config['byteorder'],
-            signed=False)
+    def _read_varint(self):
+        val = 0
+        shift = 0
+        while True:
+            byte = self._read_bytes(1)[0]
+            val |= (byte & 0x7f) << shift
+            shift += 7
+            if not byte & 0x80:
+                return val
+
+    def _read_event_description_v2(self):
+        desc_len = int.from_bytes(self._read_bytes(2),
+                                  byteorder=self.config['byteorder'],
+                                  signed=False)
+        desc = self._read_bytes(desc_len).decode('utf-8')
+        id, et = self._parse_event_description(desc)
+        self.received_events.registered_events_types[id] = et
+        self.logger.info("Received description of {}".format(et.name))
+
+    def _read_single_event_v2(self, id):
+        while id in (self.EPOCH_MARKER_ID, self.DESCRIPTION_ID):
+            if id == self.EPOCH_MARKER_ID:
+                self.timestamp_abs = int.from_bytes(
+                    self._read_bytes(8),
+                    byteorder=self.config['byteorder'],
+                    signed=False)
+            else:
+                self._read_event_description_v2()
+            id = self._read_bytes(1)[0]
+
+        if id == self.ESCAPE_ID:
+            id = int.from_bytes(self._read_bytes(2),
+                                byteorder=self.config['byteorder'],
+                                signed=False)
+        et = self.received_events.registered_events_types[id]
+
+        zigzag = self._read_varint()
+        self.timestamp_abs += (zigzag >> 1) ^ -(zigzag & 1)
+        timestamp = self.config['ms_per_timestamp_tick'] * \
+            self.timestamp_abs / 1000
+
+        data = []
+        for i in et.data_types:
+            size = self.ARG_SIZES.get(i, 4)
+            buf = self._read_bytes(size)
+            data.append(int.from_bytes(buf, byteorder=self.config['byteorder'],
+                                       signed=(i[0] == 's')))
+
+        return id, et, timestamp, data
+
+    def _read_single_event_v1(self, id):
         et = self.received_events.registered_events_types[id]
 
         buf = self._read_bytes(4)
@@ -247,33 +350,85 @@ class RttNordicProfilerHost:
             buf = self._read_bytes(4)
             data.append(int.from_bytes(buf, byteorder=self.config['byteorder'],
                                        signed=signum))
+
+        return id, et, timestamp, data
+
+    def _read_single_event_rtt(self):
+        id = int.from_bytes(
+            self._read_bytes(1),
+            byteorder=self.config['byteorder'],
+            signed=False)
+
+        if self.protocol_version == 2:
+            id, et, timestamp, data = self._read_single_event_v2(id)
+        else:
+            id, et, timestamp, data = self._read_single_event_v1(id)
+
+        if et.name == 'profiler_drop':
+            self.logger.warning("{} events dropped (context: {})".format(
+                data[1], self.DROP_CONTEXTS.get(data[0], data[0])))
+
         return Event(id, timestamp, data)
 
+    def _store_event(self, event):
+        if self.columnar_writer is not None:
+            self.columnar_writer.append(event)
+        else:
+            self.received_events.events.append(event)
+        if self.trace_writer is not None:
+            self.trace_writer.append(event)
+        if self.queue is not None:
+            self.queue.put(event)
+
     def _read_remaining_events(self):
         self.reading_data = False
         while self.bcnt != 0:
-            event = self._read_single_event_rtt()
-            self.received_events.events.append(event)
-            if self.queue is not None:
-                self.queue.put(event)
+            try:
+                event = self._read_single_event_rtt()
+            except IndexError:
+                # Recording ends in the middle of an event
+                self.logger.warning("Last event is incomplete")
+                break
+            self._store_event(event)
 
         # End of transmission
         if self.queue is not None:
             self.queue.put(None)
 
-    def read_events_rtt(self, time_seconds):
+    def _data_available(self):
+        if self.bcnt == 0:
+            buf = self.transport.read(Channel.DATA,
+                                      self.config['rtt_read_chunk_size'])
+            if len(buf) > 0:
+                self.bufs.append(buf)
+                self.bcnt += len(buf)
+        return self.bcnt > 0
+
+    def collect_events(self, time_seconds):
         self.logger.info("Start logging events data")
         self.start_logging_events()
         start_time = time.time()
-        current_time = start_time
-        while current_time - start_time < time_seconds or time_seconds < 0:
-            event = self._read_single_event_rtt()
-            self.received_events.events.append(event)
-            if self.queue is not None:
-                self.queue.put(event)
-            current_time = time.time()
+        if time_seconds >= 0:
+            self.read_deadline = start_time + time_seconds + \
+                                 self.config['read_timeout']
+        while time.time() - start_time < time_seconds or time_seconds < 0:
+            # Do not block after the time passes if device stops sending
+            if not self._data_available():
+                time.sleep(self.config['rtt_read_period'])
+                continue
+            try:
+                event = self._read_single_event_rtt()
+            except IndexError:
+                self.logger.warning("Last event is incomplete")
+                self.bufs.clear()
+                self.bcnt = 0
+                break
+            self._store_event(event)
         self.logger.info("Real time transmission closed")
         self.shutdown()
+
+    def read_events_rtt(self, time_seconds):
+        self.collect_events(time_seconds)
         self.logger.info("Events data saved to files")
         sys.exit()
 
@@ -283,10 +438,22 @@ class RttNordicProfilerHost:
     def stop_logging_events(self):
         self._send_command(Command.STOP)
 
+    def start_sampling(self):
+        self.sampling = True
+        self._send_command(Command.SAMPLING_START)
+
+    def stop_sampling(self):
+        self._send_command(Command.SAMPLING_STOP)
+        # Send the samples collected since the last report
+        self._send_command(Command.SAMPLING_DUMP)
+        # Device polls for commands every 500 ms
+        time.sleep(1)
+        self.sampling = False
+
     def _send_command(self, command_type):
         command = bytearray(1)
         command[0] = command_type.value
         try:
-            self.jlink.rtt_write(self.config['rtt_command_channel'], command, None)
+            self.transport.write_command(command)
         except:
             self.logger.error("Problem with writing RTT data.")
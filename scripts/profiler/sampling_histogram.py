@@ -0,0 +1,160 @@
+# Copyright (c) 2019 Nordic Semiconductor ASA
+# SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+
+from events import EventsData
+from bisect import bisect_right
+from collections import Counter
+import argparse
+import logging
+import sys
+
+
+class Symbolizer():
+    def __init__(self, elf_filename, logger):
+        try:
+            from elftools.elf.elffile import ELFFile
+            from elftools.elf.sections import SymbolTableSection
+        except ImportError:
+            logger.error("pyelftools is required to read symbols from "
+                         "the ELF file")
+            sys.exit()
+
+        self.functions = []
+        self.objects = {}
+        with open(elf_filename, 'rb') as f:
+            elf = ELFFile(f)
+            for section in elf.iter_sections():
+                if not isinstance(section, SymbolTableSection):
+                    continue
+                for sym in section.iter_symbols():
+                    sym_type = sym['st_info']['type']
+                    if sym_type == 'STT_FUNC':
+                        # Thumb functions have the lowest address bit set
+                        addr = sym['st_value'] & ~1
+                        self.functions.append((addr, sym['st_size'],
+                                               sym.name))
+                    elif sym_type == 'STT_OBJECT':
+                        self.objects[sym['st_value']] = sym.name
+
+        self.functions.sort()
+        self.function_addrs = [f[0] for f in self.functions]
+
+    def function(self, pc):
+        if pc == 0:
+            return '[unknown]'
+        idx = bisect_right(self.function_addrs, pc) - 1
+        if idx >= 0:
+            addr, size, name = self.functions[idx]
+            if pc < addr + size or size == 0:
+                return name
+        return '0x{:08x}'.format(pc)
+
+    def thread(self, thread):
+        return self.objects.get(thread, 'thread_0x{:08x}'.format(thread))
+
+
+class SamplingHistogram():
+    """Flat histogram of sampled program counters per thread.
+
+    Samples do not contain call stacks. They are taken in the system clock
+    interrupt, so the histogram shows only where the CPU was when the tick
+    came. Code that runs in lockstep with the tick is over- or
+    underrepresented.
+    """
+
+    def __init__(self, events_data, logger):
+        self.logger = logger
+        self.samples = Counter()
+        self.sample_cnt = 0
+        self.lost_cnt = 0
+
+        pc_id = events_data.get_event_type_id('sampling_pc')
+        summary_id = events_data.get_event_type_id('sampling_summary')
+        if pc_id is None or summary_id is None:
+            self.logger.error("No sampling events found")
+            sys.exit()
+
+        for ev in events_data.events:
+            if ev.type_id == pc_id:
+                pc, thread, count = ev.data
+                self.samples[(thread, pc)] += count
+            elif ev.type_id == summary_id:
+                samples, lost = ev.data
+                self.sample_cnt += samples
+                self.lost_cnt += lost
+
+        if self.lost_cnt > 0:
+            self.logger.warning("{} of {} samples did not fit in "
+                                "the histogram".format(self.lost_cnt,
+                                                       self.sample_cnt))
+
+        no_pc_cnt = sum(count for (_, pc), count in self.samples.items()
+                        if pc == 0)
+        if no_pc_cnt > 0:
+            self.logger.warning("{} of {} samples have no program counter "
+                                "(taken while other interrupt was handled or "
+                                "not on Cortex-M)".format(no_pc_cnt,
+                                                         self.sample_cnt))
+
+    def symbolize(self, symbolizer):
+        histogram = Counter()
+        for (thread, pc), count in self.samples.items():
+            histogram[(symbolizer.thread(thread),
+                       symbolizer.function(pc))] += count
+        return histogram
+
+    def print_summary(self, histogram, top):
+        total = sum(histogram.values())
+        if total == 0:
+            return
+
+        threads = Counter()
+        functions = Counter()
+        for (thread, function), count in histogram.items():
+            threads[thread] += count
+            functions[function] += count
+
+        print("Threads:")
+        for thread, count in threads.most_common():
+            print("{:6.2f}% {}".format(100 * count / total, thread))
+        print("Functions:")
+        for function, count in functions.most_common(top):
+            print("{:6.2f}% {}".format(100 * count / total, function))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Creating histogram of functions from sampling profiler data.')
+    parser.add_argument('event_csv', help='.csv file to read raw events data')
+    parser.add_argument('event_descr', help='.json file to read events descriptions')
+    parser.add_argument('elf', help='zephyr.elf file of the profiled application')
+    parser.add_argument('--output', help='.csv file to save the histogram '
+                        '(thread, function, samples)')
+    parser.add_argument('--top', type=int, default=20,
+                        help='Number of functions in the summary')
+    parser.add_argument('--log', help='Log level')
+    args = parser.parse_args()
+
+    logger = logging.getLogger('Sampling histogram')
+    logger.addHandler(logging.StreamHandler())
+    if args.log is not None:
+        logger.setLevel(int(getattr(logging, args.log.upper(), None)))
+    else:
+        logger.setLevel(logging.WARNING)
+
+    events_data = EventsData([], {})
+    events_data.read_data_from_files(args.event_csv, args.event_descr)
+
+    histogram = SamplingHistogram(events_data, logger)
+    functions = histogram.symbolize(Symbolizer(args.elf, logger))
+    histogram.print_summary(functions, args.top)
+
+    if args.output is not None:
+        with open(args.output, 'w') as f:
+            f.write("thread,function,samples\n")
+            for (thread, function), count in sorted(functions.items()):
+                f.write("{},{},{}\n".format(thread, function, count))
+
+
+if __name__ == "__main__":
+    main()
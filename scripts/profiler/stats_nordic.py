@@ -3,6 +3,8 @@
 
 from events import EventsData
 from processed_events import ProcessedEvents
+from columnar_events import ColumnarEvents
+from latency_stats import LatencyEngine
 from enum import Enum
 import matplotlib.pyplot as plt
 import numpy as np
@@ -16,13 +18,30 @@ class EventState(Enum):
     PROC_END = 3
 
 
+ENGINE_STATES = {
+    EventState.SUBMIT: 'submit',
+    EventState.PROC_START: 'start',
+    EventState.PROC_END: 'end',
+}
+
+
 class StatsNordic():
-    def __init__(self, events_filename, events_types_filename, log_lvl):
-        self.data_name = events_filename.split('.')[0]
+    def __init__(self, events_filename, events_types_filename, log_lvl,
+                 columnar_dirname=None):
         self.processed_data = ProcessedEvents()
-        self.processed_data.raw_data.read_data_from_files(
+        if columnar_dirname is not None:
+            self.data_name = columnar_dirname.rstrip('/').split('/')[-1]
+            self.processed_data.raw_data = \
+                ColumnarEvents.load(columnar_dirname).to_events_data()
+        else:
+            self.data_name = events_filename.split('.')[0]
+            self.processed_data.raw_data.read_data_from_files(
                                       events_filename, events_types_filename)
         self.processed_data.match_event_processing()
+        self.engine = self.processed_data.engine
+        if self.engine is None:
+            self.engine = LatencyEngine.from_events_data(
+                                      self.processed_data.raw_data, log_lvl)
         self.logger = logging.getLogger('Stats Nordic')
         self.logger_console = logging.StreamHandler()
         self.logger.setLevel(log_lvl)
@@ -46,36 +65,23 @@ class StatsNordic():
             self.logger.error("Event name not found: " + event_name)
             return None
 
-        trackings = list(filter(lambda x:
-                      x.submit.type_id == event_type_id,
-                      self.processed_data.tracked_events))
-
         if type(event_state) is not EventState:
             self.logger.error("Event state should be EventState enum")
             return None
 
-        if event_state == EventState.SUBMIT:
-            timestamps = np.fromiter(map(lambda x: x.submit.timestamp, trackings),
-                                     dtype=np.float)
-        elif event_state == EventState.PROC_START:
-            timestamps = np.fromiter(map(lambda x: x.proc_start_time, trackings),
-                                     dtype=np.float)
-        elif event_state == EventState.PROC_END:
-            timestamps = np.fromiter(map(lambda x: x.proc_end_time, trackings),
-                                     dtype=np.float)
-
+        timestamps = self.engine.state_times(event_type_id,
+                                             ENGINE_STATES[event_state])
         timestamps = timestamps[np.where((timestamps > start_meas)
                                          & (timestamps < end_meas))]
 
         return timestamps
 
     def calculate_times_between(self, start_times, end_times):
-        if end_times[0] <= start_times[0]:
-            end_times = end_times[1:]
-        if len(start_times) > len(end_times):
-            start_times = start_times[:-1]
+        # Every start is paired with the first end that follows it
+        pos = np.searchsorted(end_times, start_times, side='right')
+        valid = pos < len(end_times)
 
-        return (end_times - start_times) * 1000
+        return (end_times[pos[valid]] - start_times[valid]) * 1000
 
     def prepare_stats_txt(self, times_between):
         stats_text = "Max time: "
@@ -115,10 +121,13 @@ class StatsNordic():
             return
 
         if len(end_times) == 0:
-            self.logger.error("No events logged: " + stop_event_name)
+            self.logger.error("No events logged: " + end_event_name)
             return
 
         times_between = self.calculate_times_between(start_times, end_times)
+        if len(times_between) == 0:
+            self.logger.error("No events logged after: " + start_event_name)
+            return
         stats_text = self.prepare_stats_txt(times_between)
 
         plt.figure()
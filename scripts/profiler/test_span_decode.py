@@ -0,0 +1,136 @@
+# Copyright (c) 2019 Nordic Semiconductor ASA
+# SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+
+"""Decoding of spans from a recorded data stream.
+
+Run with: python3 -m unittest test_span_decode
+"""
+
+from rtt_nordic_config import RttNordicConfig
+from rtt_nordic_profiler_host import RttNordicProfilerHost
+import json
+import logging
+import os
+import tempfile
+import unittest
+
+
+SPAN_STATE_BEGIN = 0
+SPAN_STATE_END = 1
+
+THREAD_A = 0x20001000
+THREAD_B = 0x20002000
+
+# Span event types as registered by profiler_span_register
+DESCRIPTIONS = [
+    'outer,0,u8,u8,u32,state,depth,thread',
+    'inner,1,u8,u8,u32,state,depth,thread',
+]
+
+
+def encode_varint(val):
+    buf = bytearray()
+    while True:
+        byte = val & 0x7f
+        val >>= 7
+        if val:
+            buf.append(byte | 0x80)
+        else:
+            buf.append(byte)
+            return buf
+
+
+def encode_span(type_id, delta, state, depth, thread):
+    # Protocol version 2 record, the timestamp is zigzag encoded delta
+    buf = bytearray([type_id])
+    buf += encode_varint((delta << 1) ^ (delta >> 63))
+    buf += bytes([state, depth])
+    buf += thread.to_bytes(4, byteorder='little')
+    return buf
+
+
+class SpanDecodeTest(unittest.TestCase):
+
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+
+    def tearDown(self):
+        self.dir.cleanup()
+
+    def _decode(self, records):
+        data_path = os.path.join(self.dir.name, 'data.bin')
+        info_path = os.path.join(self.dir.name, 'info.txt')
+        trace_path = os.path.join(self.dir.name, 'trace.json')
+
+        with open(data_path, 'wb') as f:
+            for r in records:
+                f.write(encode_span(*r))
+        with open(info_path, 'w') as f:
+            f.write('\n'.join(DESCRIPTIONS) + '\n\n')
+
+        config = dict(RttNordicConfig)
+        config['transport'] = 'replay'
+        config['file_data_path'] = data_path
+        config['file_info_path'] = info_path
+        profiler = RttNordicProfilerHost(config=config,
+                                         trace_filename=trace_path,
+                                         log_lvl=logging.ERROR)
+        profiler.get_events_descriptions()
+        profiler.shutdown()
+
+        with open(trace_path, 'r') as f:
+            trace = json.load(f)
+
+        return profiler.received_events.events, \
+            [(r['ph'], r['name'], r['tid'], r['args'])
+             for r in trace if r.get('cat') == 'span']
+
+    def test_nested(self):
+        events, spans = self._decode([
+            (0, 0, SPAN_STATE_BEGIN, 0, THREAD_A),
+            (1, 10, SPAN_STATE_BEGIN, 1, THREAD_A),
+            (0, 5, SPAN_STATE_BEGIN, 0, THREAD_B),
+            (1, 10, SPAN_STATE_END, 1, THREAD_A),
+            (0, 5, SPAN_STATE_END, 0, THREAD_B),
+            (0, 10, SPAN_STATE_END, 0, THREAD_A),
+        ])
+
+        self.assertEqual([e.data for e in events][:2],
+                         [[SPAN_STATE_BEGIN, 0, THREAD_A],
+                          [SPAN_STATE_BEGIN, 1, THREAD_A]])
+        self.assertEqual([e.timestamp for e in events],
+                         [t * RttNordicConfig['ms_per_timestamp_tick'] /
+                          1000 for t in (0, 10, 15, 25, 30, 40)])
+        self.assertEqual(spans, [
+            ('B', 'outer', THREAD_A, {'depth': 0}),
+            ('B', 'inner', THREAD_A, {'depth': 1}),
+            ('B', 'outer', THREAD_B, {'depth': 0}),
+            ('E', 'inner', THREAD_A, {'depth': 1}),
+            ('E', 'outer', THREAD_B, {'depth': 0}),
+            ('E', 'outer', THREAD_A, {'depth': 0}),
+        ])
+
+    def test_unterminated(self):
+        _, spans = self._decode([
+            # Capture started inside of the span
+            (1, 0, SPAN_STATE_END, 1, THREAD_A),
+            (0, 10, SPAN_STATE_BEGIN, 0, THREAD_A),
+            (1, 10, SPAN_STATE_BEGIN, 1, THREAD_A),
+            # End of the inner span was lost
+            (0, 10, SPAN_STATE_END, 0, THREAD_A),
+            # Capture ended inside of the span
+            (0, 10, SPAN_STATE_BEGIN, 0, THREAD_B),
+        ])
+
+        self.assertEqual(spans, [
+            ('B', 'outer', THREAD_A, {'depth': 0}),
+            ('B', 'inner', THREAD_A, {'depth': 1}),
+            ('E', 'inner', THREAD_A, {'unterminated': True}),
+            ('E', 'outer', THREAD_A, {'depth': 0}),
+            ('B', 'outer', THREAD_B, {'depth': 0}),
+            ('E', 'outer', THREAD_B, {'unterminated': True}),
+        ])
+
+
+if __name__ == '__main__':
+    unittest.main()
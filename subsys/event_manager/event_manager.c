@@ -5,7 +5,9 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <zephyr.h>
+#include <init.h>
 #include <spinlock.h>
 #include <misc/dlist.h>
 #include <event_manager.h>
@@ -16,6 +18,15 @@ LOG_MODULE_REGISTER(event_manager, CONFIG_DESKTOP_EVENT_MANAGER_LOG_LEVEL);
 
 static void event_processor_fn(struct k_work *work);
 
+#if CONFIG_DESKTOP_EVENT_MANAGER_STATS
+static void stats_reset_fn(struct k_work *work);
+
+#define EVENT_QUEUE_STATS_INITIALIZER					\
+		.stats_reset_work = _K_WORK_INITIALIZER(stats_reset_fn),
+#else
+#define EVENT_QUEUE_STATS_INITIALIZER
+#endif
+
 
 #if CONFIG_DESKTOP_EVENT_MANAGER_PROFILER_ENABLED
 #define IDS_COUNT CONFIG_DESKTOP_EVENT_MANAGER_MAX_EVENT_CNT
@@ -23,22 +34,95 @@ static void event_processor_fn(struct k_work *work);
 #define IDS_COUNT 0
 #endif
 
-#ifdef CONFIG_SHELL
-extern u32_t event_manager_displayed_events;
+#if CONFIG_DESKTOP_EVENT_MANAGER_DELIVERY_CLASSES
+#define QUEUE_COUNT EVENT_DELIVERY_CLASS_COUNT
 #else
-static u32_t event_manager_displayed_events;
+#define QUEUE_COUNT 1
+#endif
+
+#if CONFIG_DESKTOP_EVENT_MANAGER_LOCKFREE_QUEUE
+struct event_queue {
+	sys_dnode_t *head;
+	sys_dnode_t *tail;
+	sys_dnode_t stub;
+	struct k_work work;
+	struct k_work_q *work_q;
+#if CONFIG_DESKTOP_EVENT_MANAGER_STATS
+	struct k_work stats_reset_work;
+#endif
+};
+
+#define EVENT_QUEUE_INITIALIZER(cls, wq)					\
+	[cls] = {								\
+		.head = &event_queues[cls].stub,				\
+		.tail = &event_queues[cls].stub,				\
+		.work = _K_WORK_INITIALIZER(event_processor_fn),		\
+		.work_q = (wq),							\
+		EVENT_QUEUE_STATS_INITIALIZER					\
+	}
+#else
+struct event_queue {
+	sys_dlist_t events;
+	struct k_spinlock lock;
+	struct k_work work;
+	struct k_work_q *work_q;
+#if CONFIG_DESKTOP_EVENT_MANAGER_STATS
+	struct k_work stats_reset_work;
+#endif
+	u32_t generation;
+};
+
+#define EVENT_QUEUE_INITIALIZER(cls, wq)					\
+	[cls] = {								\
+		.events = SYS_DLIST_STATIC_INIT(&event_queues[cls].events),	\
+		.work = _K_WORK_INITIALIZER(event_processor_fn),		\
+		.work_q = (wq),							\
+		EVENT_QUEUE_STATS_INITIALIZER					\
+	}
+#endif /* CONFIG_DESKTOP_EVENT_MANAGER_LOCKFREE_QUEUE */
+
+#if CONFIG_DESKTOP_EVENT_MANAGER_DELIVERY_CLASSES
+static K_THREAD_STACK_DEFINE(realtime_work_q_stack,
+			     CONFIG_DESKTOP_EVENT_MANAGER_REALTIME_STACK_SIZE);
+static K_THREAD_STACK_DEFINE(bulk_work_q_stack,
+			     CONFIG_DESKTOP_EVENT_MANAGER_BULK_STACK_SIZE);
+static struct k_work_q realtime_work_q;
+static struct k_work_q bulk_work_q;
+#endif
+
+#if CONFIG_DESKTOP_EVENT_MANAGER_DISPATCH_TABLE
+static bool (*dispatch_fns[CONFIG_DESKTOP_EVENT_MANAGER_DISPATCH_TABLE_SIZE])
+	    (const struct event_header *eh);
+static const struct event_listener
+	*dispatch_listeners[CONFIG_DESKTOP_EVENT_MANAGER_DISPATCH_TABLE_SIZE];
+static ATOMIC_DEFINE(dispatch_disabled,
+		     CONFIG_DESKTOP_EVENT_MANAGER_DISPATCH_TABLE_SIZE);
+static bool dispatch_table_ready;
 #endif
 
 static u16_t profiler_event_ids[IDS_COUNT];
-static K_WORK_DEFINE(event_processor, event_processor_fn);
-static sys_dlist_t eventq = SYS_DLIST_STATIC_INIT(&eventq);
-static struct k_spinlock lock;
+static struct event_queue event_queues[QUEUE_COUNT] = {
+	EVENT_QUEUE_INITIALIZER(EVENT_DELIVERY_DEFAULT, &k_sys_work_q),
+#if CONFIG_DESKTOP_EVENT_MANAGER_DELIVERY_CLASSES
+	EVENT_QUEUE_INITIALIZER(EVENT_DELIVERY_REALTIME, &realtime_work_q),
+	EVENT_QUEUE_INITIALIZER(EVENT_DELIVERY_BULK, &bulk_work_q),
+#endif
+};
 
 
+static struct event_queue *event_queue_get(const struct event_type *et)
+{
+	if (IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_DELIVERY_CLASSES)) {
+		__ASSERT_NO_MSG(et->delivery_class < QUEUE_COUNT);
+		return &event_queues[et->delivery_class];
+	}
+
+	return &event_queues[EVENT_DELIVERY_DEFAULT];
+}
+
 static bool log_is_event_displayed(const struct event_type *et)
 {
-	u32_t event_mask = BIT(et - __start_event_types);
-	return event_manager_displayed_events & event_mask;
+	return et->state->log_enabled;
 }
 
 static void log_event(const struct event_header *eh)
@@ -82,22 +166,6 @@ static void log_event_progress(const struct event_type *et,
 		(consumed)?(" (event consumed)"):(""));
 }
 
-static void log_event_init(void)
-{
-	if (!IS_ENABLED(CONFIG_LOG)) {
-		return;
-	}
-
-	for (const struct event_type *et = __start_event_types;
-	     (et != NULL) && (et != __stop_event_types);
-	     et++) {
-		if (et->init_log_enable) {
-			u32_t event_mask = BIT(et - __start_event_types);
-			event_manager_displayed_events |= event_mask;
-		}
-	}
-}
-
 static void trace_event_execution(const struct event_header *eh, bool is_start)
 {
 	size_t event_cnt = __stop_event_types - __start_event_types;
@@ -114,6 +182,10 @@ static void trace_event_execution(const struct event_header *eh, bool is_start)
 
 	profiler_log_start(&buf);
 	profiler_log_add_mem_address(&buf, eh);
+	if (IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_DELIVERY_CLASSES)) {
+		/* Host shows processing in each work queue separately. */
+		profiler_log_encode_u32(&buf, eh->type_id->delivery_class);
+	}
 	profiler_log_send(&buf, trace_evt_id);
 }
 
@@ -150,8 +222,11 @@ static void trace_event_submission(const struct event_header *eh)
 
 static void trace_register_execution_tracking_events(void)
 {
-	const char *labels[] = {"mem_address"};
-	enum profiler_arg types[] = {PROFILER_ARG_U32};
+	static const char *labels[] = {"mem_address", "delivery_class"};
+	static const enum profiler_arg types[] = {PROFILER_ARG_U32,
+						  PROFILER_ARG_U8};
+	const size_t arg_cnt =
+		IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_DELIVERY_CLASSES) ? 2 : 1;
 	size_t event_cnt = __stop_event_types - __start_event_types;
 	u16_t profiler_event_id;
 
@@ -161,13 +236,13 @@ static void trace_register_execution_tracking_events(void)
 	/* Event execution start event after last event. */
 	profiler_event_id = profiler_register_event_type(
 				"event_processing_start",
-				labels, types, 1);
+				labels, types, arg_cnt);
 	profiler_event_ids[event_cnt] = profiler_event_id;
 
 	/* Event execution end event. */
 	profiler_event_id = profiler_register_event_type(
 				"event_processing_end",
-				labels, types, 1);
+				labels, types, arg_cnt);
 	profiler_event_ids[event_cnt + 1] = profiler_event_id;
 }
 
@@ -207,24 +282,580 @@ static int trace_event_init(void)
 	return 0;
 }
 
+#if CONFIG_DESKTOP_EVENT_MANAGER_STATS
+static struct k_spinlock stats_lock;
+
+static void stats_event_submitted(struct event_header *eh, bool merged)
+{
+	struct event_type_state *state = eh->type_id->state;
+	struct event_type_stats *stats = &state->stats;
+
+	eh->timestamp = k_cycle_get_32();
+
+#if CONFIG_DESKTOP_EVENT_MANAGER_LOCKFREE_QUEUE
+	/* Counters are updated without the lock, so submitting is not
+	 * serialized. Events are never merged in the lock-free queue.
+	 */
+	u32_t depth = atomic_inc(&state->queue_depth) + 1;
+	u32_t max = __atomic_load_n(&stats->max_queue_depth,
+				    __ATOMIC_RELAXED);
+
+	__atomic_fetch_add(&stats->submitted, 1, __ATOMIC_RELAXED);
+
+	while ((depth > max) &&
+	       !__atomic_compare_exchange_n(&stats->max_queue_depth, &max,
+					    depth, true, __ATOMIC_RELAXED,
+					    __ATOMIC_RELAXED)) {
+	}
+#else
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	stats->submitted++;
+
+	if (merged) {
+		stats->merged++;
+	} else {
+		u32_t depth = atomic_inc(&state->queue_depth) + 1;
+
+		if (depth > stats->max_queue_depth) {
+			stats->max_queue_depth = depth;
+		}
+	}
+
+	k_spin_unlock(&stats_lock, key);
+#endif /* CONFIG_DESKTOP_EVENT_MANAGER_LOCKFREE_QUEUE */
+}
+
+/* Dispatch statistics of an event type and statistics of a listener for
+ * a delivery class are only updated by the work queue of the class, so the
+ * work queues do not serialize on the lock. The statistics are reset by the
+ * same work queue.
+ */
+static void stats_event_dispatched(const struct event_header *eh)
+{
+	struct event_type_state *state = eh->type_id->state;
+	struct event_type_stats *stats = &state->stats;
+	u32_t latency = k_cycle_get_32() - eh->timestamp;
+	size_t bucket = MIN(find_msb_set(latency),
+			    EVENT_MANAGER_STATS_LATENCY_BUCKET_CNT - 1);
+
+	atomic_dec(&state->queue_depth);
+
+	if ((stats->delivered == 0) || (latency < stats->latency_min)) {
+		stats->latency_min = latency;
+	}
+	if (latency > stats->latency_max) {
+		stats->latency_max = latency;
+	}
+	stats->latency_sum += latency;
+	stats->latency_hist[bucket]++;
+	stats->delivered++;
+}
+
+static bool listener_notify(const struct event_listener *el,
+			    bool (*notification)(const struct event_header *eh),
+			    const struct event_header *eh)
+{
+	struct event_queue *queue = event_queue_get(eh->type_id);
+	struct event_listener_stats *stats = &el->stats[queue - event_queues];
+	u32_t start = k_cycle_get_32();
+	bool consumed = notification(eh);
+	u32_t cycles = k_cycle_get_32() - start;
+
+	stats->notification_cnt++;
+	stats->cycles += cycles;
+
+	if (consumed) {
+		eh->type_id->state->stats.consumed++;
+	}
+
+	return consumed;
+}
+
+int event_manager_type_stats_get(const struct event_type *et,
+				 struct event_type_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	*stats = et->state->stats;
+
+	k_spin_unlock(&stats_lock, key);
+
+	return 0;
+}
+
+int event_manager_listener_stats_get(const struct event_listener *el,
+				     struct event_listener_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	memset(stats, 0, sizeof(*stats));
+
+	for (size_t i = 0; i < QUEUE_COUNT; i++) {
+		stats->notification_cnt += el->stats[i].notification_cnt;
+		stats->cycles += el->stats[i].cycles;
+	}
+
+	k_spin_unlock(&stats_lock, key);
+
+	return 0;
+}
+
+static void stats_queue_reset(struct event_queue *queue)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	for (const struct event_type *et = __start_event_types;
+	     (et != NULL) && (et != __stop_event_types);
+	     et++) {
+		struct event_type_state *state = et->state;
+
+		if (event_queue_get(et) != queue) {
+			continue;
+		}
+
+		memset(&state->stats, 0, sizeof(state->stats));
+		/* Queued events are still counted. */
+		state->stats.max_queue_depth = atomic_get(&state->queue_depth);
+	}
+
+	for (const struct event_listener *el = __start_event_listeners;
+	     el != __stop_event_listeners;
+	     el++) {
+		memset(&el->stats[queue - event_queues], 0,
+		       sizeof(el->stats[0]));
+	}
+
+	k_spin_unlock(&stats_lock, key);
+}
+
+static void stats_reset_fn(struct k_work *work)
+{
+	stats_queue_reset(CONTAINER_OF(work, struct event_queue,
+				       stats_reset_work));
+}
+
+void event_manager_stats_reset(void)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(event_queues); i++) {
+		struct event_queue *queue = &event_queues[i];
+
+		if (k_current_get() == &queue->work_q->thread) {
+			stats_queue_reset(queue);
+		} else {
+			k_work_submit_to_queue(queue->work_q,
+					       &queue->stats_reset_work);
+		}
+	}
+}
+
+#else
+static void stats_event_submitted(struct event_header *eh, bool merged)
+{
+}
+
+static void stats_event_dispatched(const struct event_header *eh)
+{
+}
+
+static bool listener_notify(const struct event_listener *el,
+			    bool (*notification)(const struct event_header *eh),
+			    const struct event_header *eh)
+{
+	return notification(eh);
+}
+
+int event_manager_type_stats_get(const struct event_type *et,
+				 struct event_type_stats *stats)
+{
+	return -ENOTSUP;
+}
+
+int event_manager_listener_stats_get(const struct event_listener *el,
+				     struct event_listener_stats *stats)
+{
+	return -ENOTSUP;
+}
+
+void event_manager_stats_reset(void)
+{
+}
+#endif /* CONFIG_DESKTOP_EVENT_MANAGER_STATS */
+
+#if CONFIG_DESKTOP_EVENT_MANAGER_DISPATCH_TABLE
+static int dispatch_table_init(void)
+{
+	size_t idx = 0;
+
+	for (const struct event_type *et = __start_event_types;
+	     (et != NULL) && (et != __stop_event_types);
+	     et++) {
+		et->state->dispatch_start = idx;
+
+		for (size_t prio = SUBS_PRIO_MIN; prio <= SUBS_PRIO_MAX; prio++) {
+			for (const struct event_subscriber *es =
+					et->subs_start[prio];
+			     es != et->subs_stop[prio];
+			     es++) {
+				if (idx >= ARRAY_SIZE(dispatch_fns)) {
+					LOG_ERR("Dispatch table too small");
+					return -ENOMEM;
+				}
+
+				__ASSERT_NO_MSG(es->listener != NULL);
+				__ASSERT_NO_MSG(es->listener->notification != NULL);
+
+				dispatch_fns[idx] = es->listener->notification;
+				dispatch_listeners[idx] = es->listener;
+				idx++;
+			}
+		}
+
+		et->state->dispatch_stop = idx;
+	}
+
+	dispatch_table_ready = true;
+
+	return 0;
+}
+
+static void event_dispatch(const struct event_header *eh)
+{
+	const struct event_type *et = eh->type_id;
+	const struct event_type_state *state = et->state;
+	bool consumed = false;
+
+	__ASSERT(dispatch_table_ready, "Event Manager not initialized");
+
+	for (size_t i = state->dispatch_start;
+	     (i < state->dispatch_stop) && !consumed;
+	     i++) {
+		if (atomic_test_bit(dispatch_disabled, i)) {
+			continue;
+		}
+
+		consumed = listener_notify(dispatch_listeners[i],
+					   dispatch_fns[i], eh);
+
+		log_event_progress(et, dispatch_listeners[i], consumed);
+	}
+}
+
+int event_manager_listener_enable(const struct event_listener *el,
+				  bool enable)
+{
+	__ASSERT_NO_MSG(dispatch_table_ready);
+
+	/* Listener may subscribe to many event types. */
+	for (size_t i = 0; i < ARRAY_SIZE(dispatch_listeners); i++) {
+		if (dispatch_listeners[i] == el) {
+			if (enable) {
+				atomic_clear_bit(dispatch_disabled, i);
+			} else {
+				atomic_set_bit(dispatch_disabled, i);
+			}
+		}
+	}
+
+	return 0;
+}
+
+bool event_manager_listener_is_enabled(const struct event_listener *el)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(dispatch_listeners); i++) {
+		if ((dispatch_listeners[i] == el) &&
+		    atomic_test_bit(dispatch_disabled, i)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+#else
+static int dispatch_table_init(void)
+{
+	return 0;
+}
+
+static void event_dispatch(const struct event_header *eh)
+{
+	const struct event_type *et = eh->type_id;
+	bool consumed = false;
+
+	for (size_t prio = SUBS_PRIO_MIN;
+	     (prio <= SUBS_PRIO_MAX) && !consumed;
+	     prio++) {
+		for (const struct event_subscriber *es =
+				et->subs_start[prio];
+		     (es != et->subs_stop[prio]) && !consumed;
+		     es++) {
+
+			__ASSERT_NO_MSG(es != NULL);
+
+			const struct event_listener *el = es->listener;
+
+			__ASSERT_NO_MSG(el != NULL);
+			__ASSERT_NO_MSG(el->notification != NULL);
+
+			consumed = listener_notify(el, el->notification, eh);
+
+			log_event_progress(et, el, consumed);
+		}
+	}
+}
+
+int event_manager_listener_enable(const struct event_listener *el,
+				  bool enable)
+{
+	return -ENOTSUP;
+}
+
+bool event_manager_listener_is_enabled(const struct event_listener *el)
+{
+	return true;
+}
+#endif /* CONFIG_DESKTOP_EVENT_MANAGER_DISPATCH_TABLE */
+
+void event_manager_event_log_enable(const struct event_type *et, bool enable)
+{
+	et->state->log_enabled = enable;
+}
+
+bool event_manager_event_log_is_enabled(const struct event_type *et)
+{
+	return et->state->log_enabled;
+}
+
+static struct event_dyndata *event_dyndata_get(const struct event_header *eh)
+{
+	const struct event_type *et = eh->type_id;
+
+	__ASSERT(et->dyndata_offset, "Event has no variable size data");
+
+	return (struct event_dyndata *)((u8_t *)eh + et->dyndata_offset);
+}
+
+void event_manager_event_ref(const struct event_header *eh)
+{
+	atomic_inc(&event_dyndata_get(eh)->ref_cnt);
+}
+
+void event_manager_event_unref(const struct event_header *eh)
+{
+	if (atomic_dec(&event_dyndata_get(eh)->ref_cnt) == 1) {
+		event_manager_free((void *)eh);
+	}
+}
+
+static void event_release(struct event_header *eh)
+{
+	if (eh->type_id->dyndata_offset) {
+		/* Listeners may still hold references. */
+		event_manager_event_unref(eh);
+	} else {
+		event_manager_free(eh);
+	}
+}
+
+static void event_process(struct event_header *eh)
+{
+	ASSERT_EVENT_ID(eh->type_id);
+
+	trace_event_execution(eh, true);
+
+	log_event(eh);
+
+	stats_event_dispatched(eh);
+
+	event_dispatch(eh);
+
+	trace_event_execution(eh, false);
+
+	event_release(eh);
+}
+
+#if CONFIG_DESKTOP_EVENT_MANAGER_LOCKFREE_QUEUE
+/* Intrusive multi-producer single-consumer queue by Dmitry Vyukov.
+ * Producers only exchange the head pointer, the consumer (work queue
+ * thread) is the only one touching the tail. Next pointer of the event
+ * list node is used to link the events.
+ */
+static void queue_push(struct event_queue *queue, sys_dnode_t *first,
+		       sys_dnode_t *last)
+{
+	last->next = NULL;
+
+	sys_dnode_t *prev = __atomic_exchange_n(&queue->head, last,
+						__ATOMIC_ACQ_REL);
+
+	/* Until the link is stored, the consumer sees the queue as empty. */
+	__atomic_store_n(&prev->next, first, __ATOMIC_RELEASE);
+}
+
+static struct event_header *queue_pop(struct event_queue *queue)
+{
+	sys_dnode_t *tail = queue->tail;
+	sys_dnode_t *next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+
+	if (tail == &queue->stub) {
+		if (!next) {
+			return NULL;
+		}
+		queue->tail = next;
+		tail = next;
+		next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+	}
+
+	if (!next) {
+		if (tail != __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE)) {
+			/* Producer is in the middle of a push. It submits
+			 * the work again when the push is complete.
+			 */
+			return NULL;
+		}
+
+		queue_push(queue, &queue->stub, &queue->stub);
+		next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+
+		if (!next) {
+			return NULL;
+		}
+	}
+
+	queue->tail = next;
+
+	return CONTAINER_OF(tail, struct event_header, node);
+}
+
 static void event_processor_fn(struct k_work *work)
 {
+	struct event_queue *queue = CONTAINER_OF(work, struct event_queue,
+						 work);
+	struct event_header *eh;
+
+	while (NULL != (eh = queue_pop(queue))) {
+		event_process(eh);
+	}
+}
+
+static bool event_queue_append(struct event_queue *queue,
+			       struct event_header *eh)
+{
+	trace_event_submission(eh);
+	stats_event_submitted(eh, false);
+	queue_push(queue, &eh->node, &eh->node);
+
+	return true;
+}
+
+static bool event_queue_append_list(struct event_queue *queue,
+				    sys_dlist_t *events)
+{
+	sys_dnode_t *node;
+
+	SYS_DLIST_FOR_EACH_NODE(events, node) {
+		struct event_header *eh =
+			CONTAINER_OF(node, struct event_header, node);
+
+		trace_event_submission(eh);
+		stats_event_submitted(eh, false);
+	}
+
+	/* Events are already linked using the next pointers. */
+	queue_push(queue, sys_dlist_peek_head(events),
+		   sys_dlist_peek_tail(events));
+	sys_dlist_init(events);
+
+	return true;
+}
+
+#else
+static void event_merge(struct event_header *queued,
+			const struct event_header *eh)
+{
+	const struct event_type *et = eh->type_id;
+
+	if (et->merge) {
+		et->merge(queued, eh);
+	} else {
+		memcpy((u8_t *)queued + sizeof(*queued),
+		       (const u8_t *)eh + sizeof(*eh),
+		       et->size - sizeof(*eh));
+	}
+}
+
+/* Must be called with the queue locked. Returns true if the event was
+ * merged into a queued event and must be freed by the caller.
+ */
+static bool event_coalesce(struct event_queue *queue,
+			   struct event_header *eh)
+{
+	const struct event_type *et = eh->type_id;
+	struct event_type_state *state = et->state;
+
+	if (!et->coalesce) {
+		return false;
+	}
+
+	if (state->coalesce_pending &&
+	    (state->coalesce_gen == queue->generation)) {
+		event_merge(state->coalesce_pending, eh);
+		return true;
+	}
+
+	state->coalesce_pending = eh;
+	state->coalesce_gen = queue->generation;
+
+	return false;
+}
+
+/* Called before the event is processed and freed. The generation already
+ * prevents merging into the event, but the pointer must not outlive it:
+ * a new event allocated at the same address could otherwise be taken for
+ * the pending one after the generation counter wraps.
+ */
+static void event_coalesce_end(struct event_queue *queue,
+			       const struct event_header *eh)
+{
+	struct event_type_state *state = eh->type_id->state;
+
+	if (!eh->type_id->coalesce) {
+		return;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+	if (state->coalesce_pending == eh) {
+		state->coalesce_pending = NULL;
+	}
+
+	k_spin_unlock(&queue->lock, key);
+}
+
+static void event_processor_fn(struct k_work *work)
+{
+	struct event_queue *queue = CONTAINER_OF(work, struct event_queue,
+						 work);
 	sys_dlist_t events;
 
 	/* Make current event list local. */
-	k_spinlock_key_t key = k_spin_lock(&lock);
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
 
-	if (sys_dlist_is_empty(&eventq)) {
-		k_spin_unlock(&lock, key);
+	if (sys_dlist_is_empty(&queue->events)) {
+		k_spin_unlock(&queue->lock, key);
 		return;
 	}
 
-	events = eventq;
+	events = queue->events;
 	events.next->prev = &events;
 	events.prev->next = &events;
-	sys_dlist_init(&eventq);
+	sys_dlist_init(&queue->events);
+
+	/* Events taken from the queue can no longer be coalesced. */
+	queue->generation++;
 
-	k_spin_unlock(&lock, key);
+	k_spin_unlock(&queue->lock, key);
 
 
 	/* Traverse the list of events. */
@@ -234,60 +865,276 @@ static void event_processor_fn(struct k_work *work)
 						       struct event_header,
 						       node);
 
-		ASSERT_EVENT_ID(eh->type_id);
+		event_coalesce_end(queue, eh);
+		event_process(eh);
+	}
+}
 
-		const struct event_type *et = eh->type_id;
+/* Submissions are traced after the events are appended, so the profiler is not
+ * called with the queue locked. Work queue threads do not run until the
+ * scheduler is unlocked or the interrupt is handled, so the events cannot be
+ * processed and freed before they are traced.
+ */
+static void trace_submission_begin(void)
+{
+	if (IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_PROFILER_ENABLED) &&
+	    !k_is_in_isr()) {
+		k_sched_lock();
+	}
+}
 
-		trace_event_execution(eh, true);
+static void trace_submission_end(void)
+{
+	if (IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_PROFILER_ENABLED) &&
+	    !k_is_in_isr()) {
+		k_sched_unlock();
+	}
+}
 
-		log_event(eh);
+static void dlist_join(sys_dlist_t *list, sys_dlist_t *list_to_append)
+{
+	sys_dnode_t *head = list_to_append->next;
+	sys_dnode_t *tail = list_to_append->prev;
 
-		bool consumed = false;
+	head->prev = list->prev;
+	tail->next = list;
 
-		for (size_t prio = SUBS_PRIO_MIN;
-		     (prio <= SUBS_PRIO_MAX) && !consumed;
-		     prio++) {
-			for (const struct event_subscriber *es =
-					et->subs_start[prio];
-			     (es != et->subs_stop[prio]) && !consumed;
-			     es++) {
+	list->prev->next = head;
+	list->prev = tail;
 
-				__ASSERT_NO_MSG(es != NULL);
+	sys_dlist_init(list_to_append);
+}
 
-				const struct event_listener *el = es->listener;
+static bool event_queue_append(struct event_queue *queue,
+			       struct event_header *eh)
+{
+	trace_submission_begin();
 
-				__ASSERT_NO_MSG(el != NULL);
-				__ASSERT_NO_MSG(el->notification != NULL);
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+	bool merged = event_coalesce(queue, eh);
 
-				consumed = el->notification(eh);
+	stats_event_submitted(eh, merged);
 
-				log_event_progress(et, el, consumed);
-			}
+	if (!merged) {
+		sys_dlist_append(&queue->events, &eh->node);
+	}
+	k_spin_unlock(&queue->lock, key);
+
+	/* Merged events are not traced, as they are never processed. */
+	if (merged) {
+		event_manager_free(eh);
+	} else {
+		trace_event_submission(eh);
+	}
+
+	trace_submission_end();
+
+	return !merged;
+}
+
+static bool event_queue_append_list(struct event_queue *queue,
+				    sys_dlist_t *events)
+{
+	sys_dlist_t merged_events;
+	sys_dnode_t *node;
+	sys_dnode_t *next;
+
+	sys_dlist_init(&merged_events);
+
+	trace_submission_begin();
+
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
+
+	SYS_DLIST_FOR_EACH_NODE_SAFE(events, node, next) {
+		struct event_header *eh =
+			CONTAINER_OF(node, struct event_header, node);
+		bool merged = event_coalesce(queue, eh);
+
+		stats_event_submitted(eh, merged);
+
+		if (merged) {
+			sys_dlist_remove(node);
+			sys_dlist_append(&merged_events, node);
 		}
+	}
 
-		trace_event_execution(eh, false);
+	bool queued = !sys_dlist_is_empty(events);
+	sys_dnode_t *first = events->next;
+	sys_dnode_t *last = events->prev;
 
-		k_free(eh);
+	if (queued) {
+		dlist_join(&queue->events, events);
 	}
+	k_spin_unlock(&queue->lock, key);
+
+	/* Events queued after the batch must not be traced here. */
+	node = first;
+	for (bool more = queued; more; node = node->next) {
+		trace_event_submission(CONTAINER_OF(node, struct event_header,
+						    node));
+		more = (node != last);
+	}
+
+	trace_submission_end();
+
+	while (NULL != (node = sys_dlist_get(&merged_events))) {
+		event_manager_free(CONTAINER_OF(node, struct event_header,
+						node));
+	}
+
+	return queued;
 }
+#endif /* CONFIG_DESKTOP_EVENT_MANAGER_LOCKFREE_QUEUE */
 
 void _event_submit(struct event_header *eh)
 {
 	__ASSERT_NO_MSG(eh);
 	ASSERT_EVENT_ID(eh->type_id);
 
-	trace_event_submission(eh);
+	struct event_queue *queue = event_queue_get(eh->type_id);
+
+	if (event_queue_append(queue, eh)) {
+		k_work_submit_to_queue(queue->work_q, &queue->work);
+	}
+}
+
+void event_submit_batch(sys_dlist_t *batch)
+{
+	sys_dlist_t batch_queued[QUEUE_COUNT];
+
+	__ASSERT_NO_MSG(batch);
+
+	for (size_t i = 0; i < ARRAY_SIZE(batch_queued); i++) {
+		sys_dlist_init(&batch_queued[i]);
+	}
+
+	/* Split the batch between event queues. */
+	sys_dnode_t *node;
+	while (NULL != (node = sys_dlist_get(batch))) {
+		struct event_header *eh = CONTAINER_OF(node,
+						       struct event_header,
+						       node);
+
+		ASSERT_EVENT_ID(eh->type_id);
+
+		size_t queue_idx = event_queue_get(eh->type_id) - event_queues;
+
+		sys_dlist_append(&batch_queued[queue_idx], node);
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(batch_queued); i++) {
+		struct event_queue *queue = &event_queues[i];
 
-	k_spinlock_key_t key = k_spin_lock(&lock);
-	sys_dlist_append(&eventq, &eh->node);
-	k_spin_unlock(&lock, key);
+		if (sys_dlist_is_empty(&batch_queued[i])) {
+			continue;
+		}
+
+		if (event_queue_append_list(queue, &batch_queued[i])) {
+			k_work_submit_to_queue(queue->work_q, &queue->work);
+		}
+	}
+}
+
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_ALLOC_HEAP
+void *event_manager_alloc(size_t size)
+{
+	return k_malloc(size);
+}
+
+void event_manager_free(void *addr)
+{
+	k_free(addr);
+}
+
+int event_manager_pool_stats_get(size_t pool_idx,
+				 struct event_manager_pool_stats *stats)
+{
+	return -ENOTSUP;
+}
+#endif /* CONFIG_DESKTOP_EVENT_MANAGER_ALLOC_HEAP */
+
+static int event_alloc_check(void)
+{
+#ifdef CONFIG_DESKTOP_EVENT_MANAGER_ALLOC_POOL
+	/* Every event type must fit in the largest pool block. */
+	for (const struct event_type *et = __start_event_types;
+	     (et != NULL) && (et != __stop_event_types);
+	     et++) {
+		if (et->size > CONFIG_DESKTOP_EVENT_MANAGER_POOL_LARGE_BLOCK_SIZE) {
+			LOG_ERR("Event %s (%zu bytes) does not fit in event pool",
+				et->name, et->size);
+			return -ENOMEM;
+		}
+	}
+#endif /* CONFIG_DESKTOP_EVENT_MANAGER_ALLOC_POOL */
+
+	return 0;
+}
+
+static int event_coalesce_check(void)
+{
+	for (const struct event_type *et = __start_event_types;
+	     (et != NULL) && (et != __stop_event_types);
+	     et++) {
+		/* Queued events cannot be found without the lock. */
+		if (et->coalesce &&
+		    IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_LOCKFREE_QUEUE)) {
+			LOG_ERR("Event %s cannot be coalesced in lock-free "
+				"queue", et->name);
+			return -EINVAL;
+		}
 
-	k_work_submit(&event_processor);
+		/* Variable size data cannot be replaced in place. */
+		if (et->coalesce && et->dyndata_offset && !et->merge) {
+			LOG_ERR("Event %s with variable size data requires "
+				"merge function", et->name);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
 }
 
+#if CONFIG_DESKTOP_EVENT_MANAGER_DELIVERY_CLASSES
+static int event_work_q_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_work_q_start(&realtime_work_q, realtime_work_q_stack,
+		       K_THREAD_STACK_SIZEOF(realtime_work_q_stack),
+		       CONFIG_DESKTOP_EVENT_MANAGER_REALTIME_PRIORITY);
+
+	k_work_q_start(&bulk_work_q, bulk_work_q_stack,
+		       K_THREAD_STACK_SIZEOF(bulk_work_q_stack),
+		       CONFIG_DESKTOP_EVENT_MANAGER_BULK_PRIORITY);
+
+	return 0;
+}
+
+/* Start work queues together with the system work queue, so events can be
+ * submitted as soon as the application starts.
+ */
+SYS_INIT(event_work_q_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif /* CONFIG_DESKTOP_EVENT_MANAGER_DELIVERY_CLASSES */
+
 int event_manager_init(void)
 {
-	log_event_init();
+	int err = event_alloc_check();
+
+	if (err) {
+		return err;
+	}
+
+	err = event_coalesce_check();
+	if (err) {
+		return err;
+	}
+
+	err = dispatch_table_init();
+	if (err) {
+		return err;
+	}
+
 
 	return trace_event_init();
 }
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <spinlock.h>
+#include <event_manager.h>
+
+
+#define POOL_ALIGN 4
+
+BUILD_ASSERT_MSG((CONFIG_DESKTOP_EVENT_MANAGER_POOL_SMALL_BLOCK_SIZE <
+		  CONFIG_DESKTOP_EVENT_MANAGER_POOL_MEDIUM_BLOCK_SIZE) &&
+		 (CONFIG_DESKTOP_EVENT_MANAGER_POOL_MEDIUM_BLOCK_SIZE <
+		  CONFIG_DESKTOP_EVENT_MANAGER_POOL_LARGE_BLOCK_SIZE),
+		 "Event pool block sizes must be increasing");
+
+K_MEM_SLAB_DEFINE(event_pool_small,
+		  CONFIG_DESKTOP_EVENT_MANAGER_POOL_SMALL_BLOCK_SIZE,
+		  CONFIG_DESKTOP_EVENT_MANAGER_POOL_SMALL_BLOCK_CNT,
+		  POOL_ALIGN);
+
+K_MEM_SLAB_DEFINE(event_pool_medium,
+		  CONFIG_DESKTOP_EVENT_MANAGER_POOL_MEDIUM_BLOCK_SIZE,
+		  CONFIG_DESKTOP_EVENT_MANAGER_POOL_MEDIUM_BLOCK_CNT,
+		  POOL_ALIGN);
+
+K_MEM_SLAB_DEFINE(event_pool_large,
+		  CONFIG_DESKTOP_EVENT_MANAGER_POOL_LARGE_BLOCK_SIZE,
+		  CONFIG_DESKTOP_EVENT_MANAGER_POOL_LARGE_BLOCK_CNT,
+		  POOL_ALIGN);
+
+struct event_pool {
+	struct k_mem_slab *slab;
+	u32_t max_used;
+	u32_t exhausted_cnt;
+};
+
+/* Pools must be sorted by block size. */
+static struct event_pool event_pools[] = {
+	{ .slab = &event_pool_small },
+	{ .slab = &event_pool_medium },
+	{ .slab = &event_pool_large },
+};
+
+static struct k_spinlock lock;
+
+
+static bool pool_contains(const struct event_pool *pool, const void *addr)
+{
+	const struct k_mem_slab *slab = pool->slab;
+	const char *start = slab->buffer;
+	const char *end = start + slab->num_blocks * slab->block_size;
+
+	return ((const char *)addr >= start) && ((const char *)addr < end);
+}
+
+void *event_manager_alloc(size_t size)
+{
+	const struct event_pool *largest =
+		&event_pools[ARRAY_SIZE(event_pools) - 1];
+
+	ARG_UNUSED(largest);
+	__ASSERT(size <= largest->slab->block_size,
+		 "Event of %zu bytes does not fit in event pool block", size);
+
+	for (size_t i = 0; i < ARRAY_SIZE(event_pools); i++) {
+		struct event_pool *pool = &event_pools[i];
+		void *addr;
+
+		if (size > pool->slab->block_size) {
+			continue;
+		}
+
+		/* Slab allocation is ISR safe, the lock only keeps
+		 * the statistics consistent.
+		 */
+		k_spinlock_key_t key = k_spin_lock(&lock);
+
+		if (!k_mem_slab_alloc(pool->slab, &addr, K_NO_WAIT)) {
+			u32_t used = k_mem_slab_num_used_get(pool->slab);
+
+			if (used > pool->max_used) {
+				pool->max_used = used;
+			}
+			k_spin_unlock(&lock, key);
+
+			return addr;
+		}
+
+		/* Pool exhausted, try the bigger one. */
+		pool->exhausted_cnt++;
+		k_spin_unlock(&lock, key);
+	}
+
+	return NULL;
+}
+
+void event_manager_free(void *addr)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(event_pools); i++) {
+		struct event_pool *pool = &event_pools[i];
+
+		if (pool_contains(pool, addr)) {
+			k_mem_slab_free(pool->slab, &addr);
+			return;
+		}
+	}
+
+	__ASSERT(false, "Address does not belong to event pools");
+}
+
+int event_manager_pool_stats_get(size_t pool_idx,
+				 struct event_manager_pool_stats *stats)
+{
+	if (pool_idx >= ARRAY_SIZE(event_pools)) {
+		return -ENOENT;
+	}
+
+	const struct event_pool *pool = &event_pools[pool_idx];
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	stats->block_size = pool->slab->block_size;
+	stats->block_cnt = pool->slab->num_blocks;
+	stats->used = k_mem_slab_num_used_get(pool->slab);
+	stats->max_used = pool->max_used;
+	stats->exhausted_cnt = pool->exhausted_cnt;
+
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
@@ -8,8 +8,6 @@
 #include <shell/shell.h>
 #include <event_manager.h>
 
-u32_t event_manager_displayed_events;
-
 static int show_events(const struct shell *shell, size_t argc,
 		char **argv)
 {
@@ -24,7 +22,7 @@ static int show_events(const struct shell *shell, size_t argc,
 		shell_fprintf(shell,
 			      SHELL_NORMAL,
 			      "%c %d:\t%s\n",
-			      (event_manager_displayed_events & BIT(ev_id)) ?
+			      event_manager_event_log_is_enabled(et) ?
 				'E' : 'D',
 			      ev_id,
 			      et->name);
@@ -42,12 +40,55 @@ static int show_listeners(const struct shell *shell, size_t argc,
 	     el++) {
 
 		__ASSERT_NO_MSG(el != NULL);
-		shell_fprintf(shell, SHELL_NORMAL, "|\t[L:%s]\n", el->name);
+		shell_fprintf(shell, SHELL_NORMAL, "|\t%c %d:\t[L:%s]\n",
+			      event_manager_listener_is_enabled(el) ? 'E' : 'D',
+			      el - __start_event_listeners,
+			      el->name);
 	}
 
 	return 0;
 }
 
+static int set_listener_enabled(const struct shell *shell, size_t argc,
+				char **argv, bool enable)
+{
+	size_t listener_cnt = __stop_event_listeners - __start_event_listeners;
+	char *end;
+	long int listener_idx = strtol(argv[1], &end, 10);
+
+	if ((listener_idx < 0) || (listener_idx >= listener_cnt) ||
+	    (*end != '\0')) {
+		shell_error(shell, "Invalid listener ID: %s", argv[1]);
+		return -EINVAL;
+	}
+
+	const struct event_listener *el = __start_event_listeners + listener_idx;
+	int err = event_manager_listener_enable(el, enable);
+
+	if (err) {
+		shell_error(shell, "Cannot change listener state (err: %d)",
+			    err);
+		return err;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "Listener %s %sabled\n",
+		      el->name, enable ? "en":"dis");
+
+	return 0;
+}
+
+static int enable_listener(const struct shell *shell, size_t argc,
+			   char **argv)
+{
+	return set_listener_enabled(shell, argc, argv, true);
+}
+
+static int disable_listener(const struct shell *shell, size_t argc,
+			    char **argv)
+{
+	return set_listener_enabled(shell, argc, argv, false);
+}
+
 static int show_subscribers(const struct shell *shell, size_t argc,
 		char **argv)
 {
@@ -89,20 +130,148 @@ static int show_subscribers(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+static int show_pools(const struct shell *shell, size_t argc,
+		char **argv)
+{
+	struct event_manager_pool_stats stats;
+	size_t pool_idx = 0;
+	int err;
+
+	shell_fprintf(shell, SHELL_NORMAL, "Event pools:\n");
+
+	while (!(err = event_manager_pool_stats_get(pool_idx, &stats))) {
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "|\t%zu:\tblock size:%zu\tused:%u/%u"
+			      "\tmax used:%u\texhausted:%u\n",
+			      pool_idx, stats.block_size, stats.used,
+			      stats.block_cnt, stats.max_used,
+			      stats.exhausted_cnt);
+		pool_idx++;
+	}
+
+	if (err == -ENOTSUP) {
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "|\tEvents are allocated from heap\n");
+	}
+
+	return 0;
+}
+
+static u32_t cycles_to_us(u64_t cycles)
+{
+	return SYS_CLOCK_HW_CYCLES_TO_NS64(cycles) / NSEC_PER_USEC;
+}
+
+static void show_type_stats(const struct shell *shell,
+			    const struct event_type *et)
+{
+	struct event_type_stats stats;
+
+	if (event_manager_type_stats_get(et, &stats)) {
+		return;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "|\t[E:%s] submitted:%u merged:%u delivered:%u "
+		      "consumed:%u max queued:%u\n",
+		      et->name, stats.submitted, stats.merged,
+		      stats.delivered, stats.consumed, stats.max_queue_depth);
+
+	if (stats.delivered == 0) {
+		return;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "|\t\tlatency min/avg/max: %u/%u/%u us\n",
+		      cycles_to_us(stats.latency_min),
+		      cycles_to_us(stats.latency_sum / stats.delivered),
+		      cycles_to_us(stats.latency_max));
+
+	shell_fprintf(shell, SHELL_NORMAL, "|\t\tlatency histogram (cycles):");
+
+	for (size_t i = 0; i < ARRAY_SIZE(stats.latency_hist); i++) {
+		if (stats.latency_hist[i] == 0) {
+			continue;
+		}
+
+		if (i == ARRAY_SIZE(stats.latency_hist) - 1) {
+			shell_fprintf(shell, SHELL_NORMAL, " >=%lu:%u",
+				      BIT(i - 1), stats.latency_hist[i]);
+		} else {
+			shell_fprintf(shell, SHELL_NORMAL, " <%lu:%u",
+				      BIT(i), stats.latency_hist[i]);
+		}
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "\n");
+}
+
+static void show_listener_stats(const struct shell *shell,
+				const struct event_listener *el)
+{
+	struct event_listener_stats stats;
+
+	if (event_manager_listener_stats_get(el, &stats)) {
+		return;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "|\t[L:%s] notifications:%u total:%u us avg:%u us\n",
+		      el->name, stats.notification_cnt,
+		      cycles_to_us(stats.cycles),
+		      (stats.notification_cnt > 0) ?
+			cycles_to_us(stats.cycles / stats.notification_cnt) :
+			0);
+}
+
+static int show_stats(const struct shell *shell, size_t argc,
+		      char **argv)
+{
+	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_STATS)) {
+		shell_error(shell, "Statistics are disabled");
+		return -ENOTSUP;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "Event statistics:\n");
+	for (const struct event_type *et = __start_event_types;
+	     (et != NULL) && (et != __stop_event_types);
+	     et++) {
+		show_type_stats(shell, et);
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "Listener statistics:\n");
+	for (const struct event_listener *el = __start_event_listeners;
+	     el != __stop_event_listeners;
+	     el++) {
+		show_listener_stats(shell, el);
+	}
+
+	return 0;
+}
+
+static int reset_stats(const struct shell *shell, size_t argc,
+		       char **argv)
+{
+	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_STATS)) {
+		shell_error(shell, "Statistics are disabled");
+		return -ENOTSUP;
+	}
+
+	event_manager_stats_reset();
+	shell_fprintf(shell, SHELL_NORMAL, "Statistics reset\n");
+
+	return 0;
+}
+
 static void set_event_displaying(const struct shell *shell, size_t argc,
 				 char **argv, bool enable)
 {
-	u32_t evt_mask = 0;
-
 	/* If no IDs specified, all registered events are affected */
 	if (argc == 1) {
 		for (const struct event_type *et = __start_event_types;
 		     (et != NULL) && (et != __stop_event_types);
 		     et++) {
-
-			size_t ev_id = et - __start_event_types;
-
-			evt_mask |= BIT(ev_id);
+			event_manager_event_log_enable(et, enable);
 		}
 
 		shell_fprintf(shell,
@@ -128,11 +297,12 @@ static void set_event_displaying(const struct shell *shell, size_t argc,
 		}
 
 		for (size_t i = 0; i < ARRAY_SIZE(event_indexes); i++) {
-			evt_mask |= BIT(event_indexes[i]);
 			const struct event_type *et =
 				__start_event_types + event_indexes[i];
 			const char *event_name = et->name;
 
+			event_manager_event_log_enable(et, enable);
+
 			shell_fprintf(shell,
 				      SHELL_NORMAL,
 				      "Displaying event %s %sabled\n",
@@ -140,11 +310,6 @@ static void set_event_displaying(const struct shell *shell, size_t argc,
 				      enable ? "en":"dis");
 		}
 	}
-	if (enable) {
-		event_manager_displayed_events |= evt_mask;
-	} else {
-		event_manager_displayed_events &= ~evt_mask;
-	}
 }
 
 static int enable_event_displaying(const struct shell *shell, size_t argc,
@@ -165,15 +330,27 @@ static int disable_event_displaying(const struct shell *shell, size_t argc,
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_event_manager,
 	SHELL_CMD_ARG(show_listeners, NULL, "Show listeners",
 		      show_listeners, 0, 0),
+	SHELL_CMD_ARG(enable_listener, NULL,
+		      "Enable notifications of listener with given ID",
+		      enable_listener, 2, 0),
+	SHELL_CMD_ARG(disable_listener, NULL,
+		      "Disable notifications of listener with given ID",
+		      disable_listener, 2, 0),
 	SHELL_CMD_ARG(show_subscribers, NULL, "Show subscribers",
 		      show_subscribers, 0, 0),
 	SHELL_CMD_ARG(show_events, NULL, "Show events", show_events, 0, 0),
+	SHELL_CMD_ARG(show_pools, NULL, "Show event pools statistics",
+		      show_pools, 0, 0),
+	SHELL_CMD_ARG(show_stats, NULL, "Show event and listener statistics",
+		      show_stats, 0, 0),
+	SHELL_CMD_ARG(reset_stats, NULL, "Reset event and listener statistics",
+		      reset_stats, 0, 0),
 	SHELL_CMD_ARG(disable, NULL, "Disable displaying event with given ID",
 		      disable_event_displaying, 0,
-		      sizeof(event_manager_displayed_events) * 8 - 1),
+		      CONFIG_SHELL_ARGC_MAX - 1),
 	SHELL_CMD_ARG(enable, NULL, "Enable displaying event with given ID",
 		      enable_event_displaying, 0,
-		      sizeof(event_manager_displayed_events) * 8 - 1),
+		      CONFIG_SHELL_ARGC_MAX - 1),
 	SHELL_SUBCMD_SET_END
 );
 
@@ -10,42 +10,50 @@
 #include <shell/shell_rtt.h>
 #include <profiler.h>
 
-u32_t profiler_enabled_events;
+static size_t event_cnt_get(void)
+{
+	return MIN(atomic_get(&profiler_num_events),
+		   CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS);
+}
 
 static int display_registered_events(const struct shell *shell, size_t argc,
 				char **argv)
 {
-	/* Check if flags for enabling/disabling custom event fit on u32_t */
-	static_assert(CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS <=
-		      sizeof(profiler_enabled_events) * 8,
-		      "Max 32 profiler events may be used");
 	shell_fprintf(shell, SHELL_NORMAL, "EVENTS REGISTERED IN PROFILER:\n");
-	for (size_t i = 0; i < profiler_num_events; i++) {
-		const char *event_name = profiler_get_event_descr(i);
-		/* Looking for event name delimiter (',') */
-		char *event_name_end = strchr(event_name, ',');
+	for (size_t i = 0; i < event_cnt_get(); i++) {
+		const char *event_name = profiler_get_event_name(i);
+
+		if (!event_name) {
+			continue;
+		}
 
 		shell_fprintf(shell,
 			      SHELL_NORMAL,
-			      "%c %d:\t%.*s\n",
-			      (profiler_enabled_events & BIT(i)) ? 'E' : 'D',
+			      "%c %d:\t%s\n",
+			      is_profiling_enabled(i) ? 'E' : 'D',
 			      i,
-			      event_name_end - event_name,
 			      event_name);
 	}
 
 	return 0;
 }
 
+static void set_event_enabled(size_t profiler_event_id, bool enable)
+{
+	if (enable) {
+		atomic_set_bit(profiler_enabled_events, profiler_event_id);
+	} else {
+		atomic_clear_bit(profiler_enabled_events, profiler_event_id);
+	}
+}
+
 static void set_event_profiling(const struct shell *shell, size_t argc,
 				char **argv, bool enable)
 {
-	u32_t evt_mask = 0;
-
 	/* If no IDs specified, all registered events are affected */
 	if (argc == 1) {
-		for (int i = 0; i < profiler_num_events; i++) {
-			evt_mask |= BIT(i);
+		for (size_t i = 0; i < event_cnt_get(); i++) {
+			set_event_enabled(i, enable);
 		}
 
 		shell_fprintf(shell,
@@ -62,7 +70,7 @@ static void set_event_profiling(const struct shell *shell, size_t argc,
 			event_indexes[i] = strtol(argv[i + 1], &end, 10);
 
 			if (event_indexes[i] < 0 ||
-			    event_indexes[i] >= profiler_num_events ||
+			    !profiler_get_event_name(event_indexes[i]) ||
 			    *end != '\0') {
 				shell_error(shell, "Invalid event ID: %s",
 					    argv[i + 1]);
@@ -71,25 +79,17 @@ static void set_event_profiling(const struct shell *shell, size_t argc,
 		}
 
 		for (size_t i = 0; i < index_cnt; i++) {
-			evt_mask |= BIT(event_indexes[i]);
-			const char *event_name = profiler_get_event_descr(
+			set_event_enabled(event_indexes[i], enable);
+			const char *event_name = profiler_get_event_name(
 							event_indexes[i]);
-			/* Looking for event name delimiter (',') */
-			char *event_name_end = strchr(event_name, ',');
 
 			shell_fprintf(shell,
 				      SHELL_NORMAL,
-				      "Profiling event %.*s %sabled\n",
-				      event_name_end - event_name,
+				      "Profiling event %s %sabled\n",
 				      event_name,
 				      enable ? "en":"dis");
 		}
 	}
-	if (enable) {
-		profiler_enabled_events |= evt_mask;
-	} else {
-		profiler_enabled_events &= ~evt_mask;
-	}
 }
 
 static int enable_event_profiling(const struct shell *shell, size_t argc,
@@ -106,6 +106,41 @@ static int disable_event_profiling(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+#ifdef CONFIG_PROFILER_SPAN_STATS
+static int display_span_stats(const struct shell *shell, size_t argc,
+			      char **argv)
+{
+	if ((argc > 1) && !strcmp(argv[1], "reset")) {
+		profiler_span_stats_reset();
+		shell_fprintf(shell, SHELL_NORMAL, "Span statistics reset\n");
+		return 0;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "SPAN STATISTICS (count min/mean/max [us]):\n");
+	for (size_t i = 0; i < CONFIG_PROFILER_SPAN_MAX_CNT; i++) {
+		const char *span_name = profiler_span_name_get(i);
+		struct profiler_span_stats stats;
+
+		if (!span_name || profiler_span_stats_get(i, &stats)) {
+			continue;
+		}
+
+		shell_fprintf(shell,
+			      SHELL_NORMAL,
+			      "%d:\t%s\t%u %u/%u/%u\n",
+			      i,
+			      span_name,
+			      stats.count,
+			      stats.min,
+			      stats.mean,
+			      stats.max);
+	}
+
+	return 0;
+}
+#endif
+
 
 SHELL_CREATE_STATIC_SUBCMD_SET(sub_profiler)
 {
@@ -113,10 +148,15 @@ SHELL_CREATE_STATIC_SUBCMD_SET(sub_profiler)
 			display_registered_events, 0, 0),
 	SHELL_CMD_ARG(enable, NULL, "Enable profiling of event with given ID",
 			enable_event_profiling, 1,
-			sizeof(profiler_enabled_events) * 8),
+			CONFIG_SHELL_ARGC_MAX - 1),
 	SHELL_CMD_ARG(disable, NULL, "Disable profiling of event with given ID",
 			disable_event_profiling, 1,
-			sizeof(profiler_enabled_events) * 8),
+			CONFIG_SHELL_ARGC_MAX - 1),
+#ifdef CONFIG_PROFILER_SPAN_STATS
+	SHELL_CMD_ARG(span_stats, NULL,
+			"Display span statistics, reset with \"reset\"",
+			display_span_stats, 1, 1),
+#endif
 	SHELL_SUBCMD_SET_END
 };
 
@@ -5,35 +5,98 @@
  */
 
 #include <stdio.h>
+#include <limits.h>
 #include <kernel_structs.h>
 #include <misc/printk.h>
 #include <misc/util.h>
 #include <misc/byteorder.h>
 #include <zephyr.h>
-#include <SEGGER_RTT.h>
 #include <profiler.h>
 #include <string.h>
 
+#include "profiler_nordic_ring.h"
+#include "profiler_nordic_sampling.h"
+#include "profiler_nordic_transport.h"
+
+
+ATOMIC_DEFINE(profiler_enabled_events, CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS);
+atomic_t profiler_num_events;
 
-/* By default, when there is no shell, all events are profiled. */
-#ifndef CONFIG_SHELL
-u32_t profiler_enabled_events = 0xffffffff;
-#endif
 
+/* Records are buffered separately for threads and interrupts and sent to
+ * the host by the drain thread.
+ */
+enum profiler_context {
+	PROFILER_CONTEXT_THREAD,
+	PROFILER_CONTEXT_ISR,
+
+	PROFILER_CONTEXT_COUNT,
 
-static K_SEM_DEFINE(profiler_sem, 0, 1);
+	/* Records dropped by the transport. */
+	PROFILER_CONTEXT_TRANSPORT = PROFILER_CONTEXT_COUNT
+};
+
+static K_SEM_DEFINE(profiler_sem, 0, 2);
 static bool protocol_running;
 static bool sending_events;
 
 enum nordic_command {
 	NORDIC_COMMAND_START	= 1,
 	NORDIC_COMMAND_STOP	= 2,
-	NORDIC_COMMAND_INFO	= 3
+	NORDIC_COMMAND_INFO	= 3,
+	NORDIC_COMMAND_INFO_V2	= 4,
+	NORDIC_COMMAND_SAMPLING_START	= 5,
+	NORDIC_COMMAND_SAMPLING_STOP	= 6,
+	NORDIC_COMMAND_SAMPLING_DUMP	= 7
+};
+
+/* Protocol version is selected by the INFO command sent by the host.
+ * Firmware without version 2 asserts on unknown commands, so the host sends
+ * the INFO command of version 1 first. The response to it ends with a line
+ * that advertises the highest supported version (see
+ * send_protocol_version), which hosts of version 1 do not read.
+ *
+ * Version 1 record: type ID (1 byte), timestamp (4 bytes), every argument
+ * on 4 bytes. Only event types with IDs up to 255 can be sent.
+ *
+ * Version 2 record: type ID (1 byte, or escape byte followed by 2 bytes),
+ * timestamp delta to the previous record (zigzag LEB128), every argument on
+ * its native size. An epoch marker carries the absolute 64-bit timestamp.
+ * It is sent before the first record and when the 32-bit timestamp wraps.
+ * Description of an event type is sent in-band (2-byte length followed by
+ * the text) before the first record of the type that was not described
+ * in the response to the INFO command.
+ */
+enum nordic_protocol {
+	NORDIC_PROTOCOL_V1	= 1,
+	NORDIC_PROTOCOL_V2	= 2
 };
 
-char descr[CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS]
-	  [CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS];
-static char *arg_types_encodings[] = {
+#define TYPE_ID_DESCRIPTION	0xfd
+#define TYPE_ID_ESCAPE		0xfe
+#define TYPE_ID_EPOCH_MARKER	0xff
+
+/* Records in ring buffers: type ID (2 bytes), timestamp (4 bytes), every
+ * argument on 4 bytes.
+ */
+#define RECORD_HEADER_SIZE	(sizeof(u16_t) + sizeof(u32_t))
+
+BUILD_ASSERT_MSG(CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS <= UINT16_MAX,
+		 "Event type IDs are limited to 16 bits");
+
+/* Description is created from the registration data when it is sent. */
+struct event_type_info {
+	const char *name;
+	const char **args;
+	const enum profiler_arg *arg_types;
+	u8_t arg_cnt;
+};
+
+static struct event_type_info event_types[CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS];
+static ATOMIC_DEFINE(registered_events, CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS);
+static ATOMIC_DEFINE(described_events, CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS);
+
+static const char * const arg_types_encodings[] = {
 					"u8",  /* u8_t */
 					"s8",  /* s8_t */
 					"u16", /* u16_t */
@@ -44,47 +107,100 @@ static char *arg_types_encodings[] = {
 					"t"    /* time */
 				     };
 
-u8_t profiler_num_events;
-
-static u8_t buffer_data[CONFIG_PROFILER_NORDIC_DATA_BUFFER_SIZE];
-static u8_t buffer_info[CONFIG_PROFILER_NORDIC_INFO_BUFFER_SIZE];
-static u8_t buffer_commands[CONFIG_PROFILER_NORDIC_COMMAND_BUFFER_SIZE];
+static enum nordic_protocol protocol_version = NORDIC_PROTOCOL_V1;
+static bool epoch_sync_needed;
+static u32_t last_timestamp;
+static u32_t epoch;
 
 static k_tid_t protocol_thread_id;
+static k_tid_t drain_thread_id;
 
 static K_THREAD_STACK_DEFINE(profiler_nordic_stack,
 			     CONFIG_PROFILER_NORDIC_STACK_SIZE);
 static struct k_thread profiler_nordic_thread;
 
-static void send_system_description(void)
+static K_THREAD_STACK_DEFINE(profiler_drain_stack,
+			     CONFIG_PROFILER_NORDIC_DRAIN_STACK_SIZE);
+static struct k_thread profiler_drain_thread;
+
+static struct profiler_ring rings[PROFILER_CONTEXT_COUNT];
+static atomic_t transport_dropped;
+static u16_t drop_event_id;
+
+static void send_info(const void *data, size_t len)
 {
-	size_t num_bytes_send;
+	size_t num_bytes_send = profiler_transport_send(
+					PROFILER_TRANSPORT_CHANNEL_INFO,
+					data, len);
 
-	/* Memory barrier to make sure that data is visible
-	 * before being accessed
-	 */
-	u8_t ne = profiler_num_events;
+	ARG_UNUSED(num_bytes_send);
+	__ASSERT_NO_MSG(num_bytes_send > 0);
+}
+
+static bool event_type_is_registered(size_t id)
+{
+	return (id < CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS) &&
+	       atomic_test_bit(registered_events, id);
+}
+
+static size_t event_type_descr_get(size_t id, char *buf, size_t size)
+{
+	const struct event_type_info *info = &event_types[id];
+	int temp = snprintf(buf, size, "%s,%u", info->name,
+			    (unsigned int)id);
+	size_t pos = temp;
 
-	__DMB();
+	__ASSERT_NO_MSG((temp > 0) && (pos < size));
+
+	for (size_t t = 0; t < info->arg_cnt; t++) {
+		temp = snprintf(buf + pos, size - pos, ",%s",
+				arg_types_encodings[info->arg_types[t]]);
+		pos += temp;
+		__ASSERT_NO_MSG((temp > 0) && (pos < size));
+	}
+
+	for (size_t t = 0; t < info->arg_cnt; t++) {
+		temp = snprintf(buf + pos, size - pos, ",%s", info->args[t]);
+		pos += temp;
+		__ASSERT_NO_MSG((temp > 0) && (pos < size));
+	}
+
+	return pos;
+}
+
+static void send_system_description(void)
+{
+	static char descr[CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS];
+	size_t ne = MIN(atomic_get(&profiler_num_events),
+			CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS);
 	char end_line = '\n';
 
+	/* Protocol version 1 cannot describe event types registered later. */
+	if (protocol_version == NORDIC_PROTOCOL_V1) {
+		ne = MIN(ne, UCHAR_MAX + 1);
+	}
+
+	for (size_t t = 0; t < ARRAY_SIZE(described_events); t++) {
+		atomic_set(&described_events[t], 0);
+	}
+
 	for (size_t t = 0; t < ne; t++) {
-		num_bytes_send = SEGGER_RTT_WriteNoLock(
-				  CONFIG_PROFILER_NORDIC_RTT_CHANNEL_INFO,
-				  descr[t],
-				  strlen(descr[t]));
-		__ASSERT_NO_MSG(num_bytes_send > 0);
-		num_bytes_send = SEGGER_RTT_WriteNoLock(
-				  CONFIG_PROFILER_NORDIC_RTT_CHANNEL_INFO,
-				  &end_line,
-				  1);
-		__ASSERT_NO_MSG(num_bytes_send > 0);
+		if (!event_type_is_registered(t) ||
+		    atomic_test_and_set_bit(described_events, t)) {
+			continue;
+		}
+
+		send_info(descr, event_type_descr_get(t, descr, sizeof(descr)));
+		send_info(&end_line, 1);
 	}
-	num_bytes_send = SEGGER_RTT_WriteNoLock(
-			  CONFIG_PROFILER_NORDIC_RTT_CHANNEL_INFO,
-			  &end_line,
-			  1);
-	__ASSERT_NO_MSG(num_bytes_send > 0);
+	send_info(&end_line, 1);
+}
+
+static void send_protocol_version(void)
+{
+	static const char version[] = "protocol_version,2\n";
+
+	send_info(version, sizeof(version) - 1);
 }
 
 static void profiler_nordic_thread_fn(void)
@@ -93,22 +209,38 @@ static void profiler_nordic_thread_fn(void)
 		u8_t read_data;
 		enum nordic_command command;
 
-		if (SEGGER_RTT_Read(
-		     CONFIG_PROFILER_NORDIC_RTT_CHANNEL_COMMANDS,
-		     &read_data, sizeof(read_data))) {
+		if (profiler_transport_command_read(&read_data)) {
 			command = (enum nordic_command)read_data;
 			switch (command) {
 			case NORDIC_COMMAND_START:
+				epoch_sync_needed = true;
 				sending_events = true;
 				break;
 			case NORDIC_COMMAND_STOP:
 				sending_events = false;
 				break;
 			case NORDIC_COMMAND_INFO:
+				protocol_version = NORDIC_PROTOCOL_V1;
 				send_system_description();
+				send_protocol_version();
 				break;
+			case NORDIC_COMMAND_INFO_V2:
+				protocol_version = NORDIC_PROTOCOL_V2;
+				send_system_description();
+				break;
+#ifdef CONFIG_PROFILER_NORDIC_SAMPLING
+			case NORDIC_COMMAND_SAMPLING_START:
+				profiler_sampling_start();
+				break;
+			case NORDIC_COMMAND_SAMPLING_STOP:
+				profiler_sampling_stop();
+				break;
+			case NORDIC_COMMAND_SAMPLING_DUMP:
+				profiler_sampling_dump();
+				break;
+#endif
 			default:
-				__ASSERT_NO_MSG(false);
+				/* Ignore commands of newer protocols. */
 				break;
 			}
 		}
@@ -117,37 +249,269 @@ static void profiler_nordic_thread_fn(void)
 	k_sem_give(&profiler_sem);
 }
 
+static bool send_data(const u8_t *data, size_t len)
+{
+	size_t num_bytes_send = profiler_transport_send(
+				PROFILER_TRANSPORT_CHANNEL_DATA, data, len);
+
+	if (num_bytes_send == 0) {
+		atomic_inc(&transport_dropped);
+		return false;
+	}
+
+	return true;
+}
+
+static u8_t *encode_varint(u8_t *pos, u32_t val)
+{
+	while (val >= 0x80) {
+		*pos++ = (val & 0x7f) | 0x80;
+		val >>= 7;
+	}
+	*pos++ = val;
+
+	return pos;
+}
+
+static size_t arg_size(enum profiler_arg type)
+{
+	switch (type) {
+	case PROFILER_ARG_U8:
+	case PROFILER_ARG_S8:
+		return sizeof(u8_t);
+	case PROFILER_ARG_U16:
+	case PROFILER_ARG_S16:
+		return sizeof(u16_t);
+	default:
+		return sizeof(u32_t);
+	}
+}
+
+static void send_epoch_marker(u32_t timestamp)
+{
+	u8_t marker[sizeof(u8_t) + sizeof(u64_t)];
+
+	marker[0] = TYPE_ID_EPOCH_MARKER;
+	sys_put_le64(((u64_t)epoch << 32) | timestamp, &marker[1]);
+	send_data(marker, sizeof(marker));
+
+	last_timestamp = timestamp;
+}
+
+static void send_descr_v2(u16_t type_id)
+{
+	static u8_t out[sizeof(u8_t) + sizeof(u16_t) +
+			CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS];
+	const size_t header_size = sizeof(u8_t) + sizeof(u16_t);
+	size_t len = event_type_descr_get(type_id, (char *)&out[header_size],
+					  sizeof(out) - header_size);
+
+	out[0] = TYPE_ID_DESCRIPTION;
+	sys_put_le16(len, &out[sizeof(u8_t)]);
+
+	if (!send_data(out, header_size + len)) {
+		/* Retry before the next record of the type. */
+		atomic_clear_bit(described_events, type_id);
+	}
+}
+
+static void send_record_v2(const u8_t *record, size_t len)
+{
+	u8_t out[CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN + sizeof(u16_t)];
+	u16_t type_id = sys_get_le16(record);
+	u32_t timestamp = sys_get_le32(&record[sizeof(u16_t)]);
+	s32_t delta = timestamp - last_timestamp;
+	const struct event_type_info *info = &event_types[type_id];
+
+	__ASSERT_NO_MSG(len == RECORD_HEADER_SIZE +
+			       info->arg_cnt * sizeof(u32_t));
+
+	if (!atomic_test_and_set_bit(described_events, type_id)) {
+		send_descr_v2(type_id);
+	}
+
+	if (epoch_sync_needed) {
+		epoch_sync_needed = false;
+		send_epoch_marker(timestamp);
+		delta = 0;
+	} else if ((delta >= 0) && (timestamp < last_timestamp)) {
+		epoch++;
+		send_epoch_marker(timestamp);
+		delta = 0;
+	}
+
+	/* Host follows the same sequence of timestamps. */
+	last_timestamp = timestamp;
+
+	u8_t *pos = out;
+
+	if (type_id < TYPE_ID_DESCRIPTION) {
+		*pos++ = type_id;
+	} else {
+		*pos++ = TYPE_ID_ESCAPE;
+		sys_put_le16(type_id, pos);
+		pos += sizeof(u16_t);
+	}
+	pos = encode_varint(pos, ((u32_t)delta << 1) ^ (u32_t)(delta >> 31));
+
+	const u8_t *arg = &record[RECORD_HEADER_SIZE];
+
+	for (size_t i = 0; i < info->arg_cnt; i++) {
+		size_t size = arg_size(info->arg_types[i]);
+
+		/* Arguments are stored little-endian on 4 bytes. */
+		memcpy(pos, arg, size);
+		pos += size;
+		arg += sizeof(u32_t);
+	}
+
+	send_data(out, pos - out);
+}
+
+static void send_record_v1(const u8_t *record, size_t len)
+{
+	u8_t out[CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN];
+	u16_t type_id = sys_get_le16(record);
+
+	if (type_id > UCHAR_MAX) {
+		atomic_inc(&transport_dropped);
+		return;
+	}
+
+	out[0] = type_id;
+	memcpy(&out[sizeof(u8_t)], &record[sizeof(u16_t)],
+	       len - sizeof(u16_t));
+	send_data(out, len - sizeof(u16_t) + sizeof(u8_t));
+}
+
+static void send_record(const u8_t *record, size_t len)
+{
+	if (protocol_version == NORDIC_PROTOCOL_V2) {
+		send_record_v2(record, len);
+	} else {
+		send_record_v1(record, len);
+	}
+}
+
+static void send_drop_event(enum profiler_context context, u32_t dropped)
+{
+	struct log_event_buf buf;
+
+	profiler_log_start(&buf);
+	profiler_log_encode_u32(&buf, context);
+	profiler_log_encode_u32(&buf, dropped);
+
+	sys_put_le16(drop_event_id, buf.payload_start);
+	send_record(buf.payload_start, buf.payload - buf.payload_start);
+}
+
+static void send_sampling_record(struct log_event_buf *buf,
+				 u16_t event_type_id)
+{
+	sys_put_le16(event_type_id, buf->payload_start);
+	send_record(buf->payload_start, buf->payload - buf->payload_start);
+}
+
+static bool record_is_older(const u8_t *record, const u8_t *ref)
+{
+	/* Timestamp directly follows the event type ID. */
+	u32_t timestamp = sys_get_le32(record + sizeof(u16_t));
+	u32_t ref_timestamp = sys_get_le32(ref + sizeof(u16_t));
+
+	return (s32_t)(timestamp - ref_timestamp) < 0;
+}
+
+static void drain(void)
+{
+	static u8_t records[PROFILER_CONTEXT_COUNT]
+			   [CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN];
+	size_t lens[PROFILER_CONTEXT_COUNT] = {0};
+
+	/* Merge records from all contexts in timestamp order. */
+	while (true) {
+		size_t oldest = PROFILER_CONTEXT_COUNT;
+
+		for (size_t i = 0; i < PROFILER_CONTEXT_COUNT; i++) {
+			if (lens[i] == 0) {
+				lens[i] = profiler_ring_get(&rings[i],
+							    records[i],
+							    sizeof(records[i]));
+			}
+
+			if ((lens[i] > 0) &&
+			    ((oldest == PROFILER_CONTEXT_COUNT) ||
+			     record_is_older(records[i], records[oldest]))) {
+				oldest = i;
+			}
+		}
+
+		if (oldest == PROFILER_CONTEXT_COUNT) {
+			break;
+		}
+
+		send_record(records[oldest], lens[oldest]);
+		lens[oldest] = 0;
+	}
+
+	/* Report data loss in-band, after the records that were kept. */
+	for (size_t i = 0; i < PROFILER_CONTEXT_COUNT; i++) {
+		u32_t dropped = profiler_ring_dropped_get(&rings[i]);
+
+		if (dropped) {
+			send_drop_event(i, dropped);
+		}
+	}
+
+	u32_t dropped = atomic_set(&transport_dropped, 0);
+
+	if (dropped) {
+		send_drop_event(PROFILER_CONTEXT_TRANSPORT, dropped);
+	}
+
+	/* Histogram is sent directly, as it may not fit in a ring buffer. */
+	if (sending_events && profiler_sampling_report_needed()) {
+		profiler_sampling_report(send_sampling_record);
+	}
+}
+
+static void profiler_drain_thread_fn(void)
+{
+	while (protocol_running) {
+		drain();
+		k_sleep(CONFIG_PROFILER_NORDIC_DRAIN_PERIOD);
+	}
+	drain();
+	k_sem_give(&profiler_sem);
+}
+
+static void register_drop_event(void)
+{
+	static const char * const args[] = {"context", "dropped"};
+	static const enum profiler_arg arg_types[] = {PROFILER_ARG_U32,
+						      PROFILER_ARG_U32};
+
+	drop_event_id = profiler_register_event_type("profiler_drop",
+						     (const char **)args,
+						     arg_types,
+						     ARRAY_SIZE(args));
+}
+
 int profiler_init(void)
 {
+	int ret = profiler_transport_init();
+
+	if (ret) {
+		return ret;
+	}
+
+	register_drop_event();
+	profiler_sampling_init();
+
 	protocol_running = true;
 	if (IS_ENABLED(CONFIG_PROFILER_NORDIC_START_LOGGING_ON_SYSTEM_START)) {
+		epoch_sync_needed = true;
 		sending_events = true;
 	}
-	int ret;
-
-	ret = SEGGER_RTT_ConfigUpBuffer(
-		CONFIG_PROFILER_NORDIC_RTT_CHANNEL_DATA,
-		"Nordic profiler data",
-		buffer_data,
-		CONFIG_PROFILER_NORDIC_DATA_BUFFER_SIZE,
-		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
-	__ASSERT_NO_MSG(ret >= 0);
-
-	ret = SEGGER_RTT_ConfigUpBuffer(
-		CONFIG_PROFILER_NORDIC_RTT_CHANNEL_INFO,
-		"Nordic profiler info",
-		buffer_info,
-		CONFIG_PROFILER_NORDIC_INFO_BUFFER_SIZE,
-		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
-	__ASSERT_NO_MSG(ret >= 0);
-
-	ret = SEGGER_RTT_ConfigDownBuffer(
-		CONFIG_PROFILER_NORDIC_RTT_CHANNEL_COMMANDS,
-		"Nordic profiler command",
-		buffer_commands,
-		CONFIG_PROFILER_NORDIC_COMMAND_BUFFER_SIZE,
-		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
-	__ASSERT_NO_MSG(ret >= 0);
 
 	protocol_thread_id =  k_thread_create(&profiler_nordic_thread,
 			profiler_nordic_stack,
@@ -155,6 +519,13 @@ int profiler_init(void)
 			(k_thread_entry_t) profiler_nordic_thread_fn,
 			NULL, NULL, NULL,
 			CONFIG_PROFILER_NORDIC_THREAD_PRIORITY, 0, 0);
+
+	drain_thread_id = k_thread_create(&profiler_drain_thread,
+			profiler_drain_stack,
+			K_THREAD_STACK_SIZEOF(profiler_drain_stack),
+			(k_thread_entry_t) profiler_drain_thread_fn,
+			NULL, NULL, NULL,
+			CONFIG_PROFILER_NORDIC_DRAIN_THREAD_PRIORITY, 0, 0);
 	return 0;
 }
 
@@ -163,65 +534,63 @@ void profiler_term(void)
 	sending_events = false;
 	protocol_running = false;
 	k_wakeup(protocol_thread_id);
+	k_wakeup(drain_thread_id);
+	k_sem_take(&profiler_sem, K_FOREVER);
 	k_sem_take(&profiler_sem, K_FOREVER);
 }
 
-const char *profiler_get_event_descr(size_t profiler_event_id)
+const char *profiler_get_event_name(size_t profiler_event_id)
 {
-	return descr[profiler_event_id];
+	if (!event_type_is_registered(profiler_event_id)) {
+		return NULL;
+	}
+
+	return event_types[profiler_event_id].name;
 }
 
 u16_t profiler_register_event_type(const char *name, const char **args,
 				   const enum profiler_arg *arg_types,
 				   u8_t arg_cnt)
 {
-	/* Lock to make sure that this function can be called
-	 * from multiple threads
+	atomic_val_t ne;
+
+	/* Reserve the ID without locks, so that event types can be
+	 * registered from any context.
 	 */
-	k_sched_lock();
-	u8_t ne = profiler_num_events;
-	size_t temp = snprintf(descr[ne],
-			CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS,
-			"%s,%d", name, ne);
-	size_t pos = temp;
+	do {
+		ne = atomic_get(&profiler_num_events);
+		if (ne >= CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS) {
+			__ASSERT(false, "Too many event types registered");
+			return PROFILER_INVALID_EVENT_TYPE_ID;
+		}
+	} while (!atomic_cas(&profiler_num_events, ne, ne + 1));
 
-	__ASSERT_NO_MSG((pos < CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS)
-			 && (temp > 0));
+	struct event_type_info *info = &event_types[ne];
 
-	for (size_t t = 0; t < arg_cnt; t++) {
-		temp = snprintf(descr[ne] + pos,
-			 CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS - pos,
-			 ",%s", arg_types_encodings[arg_types[t]]);
-		pos += temp;
-		__ASSERT_NO_MSG(
-		  (pos < CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS)
-		   && (temp > 0));
-	}
+	info->name = name;
+	info->args = args;
+	info->arg_types = arg_types;
+	info->arg_cnt = arg_cnt;
 
-	for (size_t t = 0; t < arg_cnt; t++) {
-		temp = snprintf(descr[ne] + pos,
-			CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS - pos,
-			",%s", args[t]);
-		pos += temp;
-		__ASSERT_NO_MSG(
-		  (pos < CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS)
-		   && (temp > 0));
-	}
 	/* Memory barrier to make sure that data is visible
-	 * before being accessed
+	 * before the event type is published
 	 */
-	__DMB();
-	profiler_num_events++;
-	k_sched_unlock();
+	__sync_synchronize();
+	atomic_set_bit(registered_events, ne);
+
+	/* By default, when there is no shell, all events are profiled. */
+	if (!IS_ENABLED(CONFIG_SHELL)) {
+		atomic_set_bit(profiler_enabled_events, ne);
+	}
 
 	return ne;
 }
 
 void profiler_log_start(struct log_event_buf *buf)
 {
-	/* Adding one to pointer to make space for event type ID */
-	__ASSERT_NO_MSG(sizeof(u8_t) <= CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN);
-	buf->payload = buf->payload_start + sizeof(u8_t);
+	/* Moving pointer to make space for event type ID */
+	__ASSERT_NO_MSG(sizeof(u16_t) <= CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN);
+	buf->payload = buf->payload_start + sizeof(u16_t);
 	profiler_log_encode_u32(buf, k_cycle_get_32());
 }
 
@@ -241,19 +610,15 @@ void profiler_log_add_mem_address(struct log_event_buf *buf,
 
 void profiler_log_send(struct log_event_buf *buf, u16_t event_type_id)
 {
-	__ASSERT_NO_MSG(event_type_id <= UCHAR_MAX);
+	__ASSERT_NO_MSG(event_type_is_registered(event_type_id));
 	if (sending_events) {
-		u8_t type_id = event_type_id & UCHAR_MAX;
-
-		buf->payload_start[0] = type_id;
-		int key = irq_lock();
-
-		u8_t num_bytes_send = SEGGER_RTT_WriteNoLock(
-				CONFIG_PROFILER_NORDIC_RTT_CHANNEL_DATA,
-				buf->payload_start,
-				buf->payload - buf->payload_start);
-		ARG_UNUSED(num_bytes_send);
-		irq_unlock(key);
-		__ASSERT_NO_MSG(num_bytes_send > 0);
+		enum profiler_context context = k_is_in_isr() ?
+			PROFILER_CONTEXT_ISR : PROFILER_CONTEXT_THREAD;
+
+		sys_put_le16(event_type_id, buf->payload_start);
+
+		/* Record is sent to the host later by the drain thread. */
+		profiler_ring_put(&rings[context], buf->payload_start,
+				  buf->payload - buf->payload_start);
 	}
 }
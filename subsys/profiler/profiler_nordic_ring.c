@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <string.h>
+
+#include "profiler_nordic_ring.h"
+
+#define RING_SIZE	CONFIG_PROFILER_NORDIC_RING_BUFFER_SIZE
+#define RING_MASK	(RING_SIZE - 1)
+
+/* Every record is preceded by a header. The state byte is written last,
+ * after the record is complete. The consumer clears the whole record before
+ * the space is released, so a stale byte is never taken for a committed
+ * header.
+ */
+enum record_state {
+	RECORD_STATE_FREE,
+	RECORD_STATE_COMMITTED,
+};
+
+enum header_byte {
+	HEADER_STATE,
+	HEADER_LEN,
+
+	HEADER_SIZE
+};
+
+BUILD_ASSERT_MSG((RING_SIZE & RING_MASK) == 0,
+		 "Ring buffer size must be a power of two");
+BUILD_ASSERT_MSG(CONFIG_PROFILER_CUSTOM_EVENT_BUF_LEN <= UCHAR_MAX,
+		 "Record length must fit in the header");
+
+
+static void ring_write(struct profiler_ring *ring, u32_t idx,
+		       const u8_t *data, size_t len)
+{
+	size_t first = MIN(len, RING_SIZE - (idx & RING_MASK));
+
+	memcpy(&ring->buf[idx & RING_MASK], data, first);
+	memcpy(ring->buf, data + first, len - first);
+}
+
+static void ring_read(const struct profiler_ring *ring, u32_t idx,
+		      u8_t *data, size_t len)
+{
+	size_t first = MIN(len, RING_SIZE - (idx & RING_MASK));
+
+	memcpy(data, &ring->buf[idx & RING_MASK], first);
+	memcpy(data + first, ring->buf, len - first);
+}
+
+static void ring_clear(struct profiler_ring *ring, u32_t idx, size_t len)
+{
+	size_t first = MIN(len, RING_SIZE - (idx & RING_MASK));
+
+	memset(&ring->buf[idx & RING_MASK], RECORD_STATE_FREE, first);
+	memset(ring->buf, RECORD_STATE_FREE, len - first);
+}
+
+bool profiler_ring_put(struct profiler_ring *ring, const u8_t *data,
+		       size_t len)
+{
+	__ASSERT_NO_MSG(len <= UCHAR_MAX);
+
+	u32_t total = HEADER_SIZE + len;
+	u32_t idx;
+
+	do {
+		idx = atomic_get(&ring->reserved);
+
+		if (idx + total - (u32_t)atomic_get(&ring->read) > RING_SIZE) {
+			atomic_inc(&ring->dropped);
+			return false;
+		}
+	} while (!atomic_cas(&ring->reserved, idx, idx + total));
+
+	ring->buf[(idx + HEADER_LEN) & RING_MASK] = len;
+	ring_write(ring, idx + HEADER_SIZE, data, len);
+
+	/* Record must be complete before it is seen by the consumer. */
+	__sync_synchronize();
+	ring->buf[(idx + HEADER_STATE) & RING_MASK] = RECORD_STATE_COMMITTED;
+
+	return true;
+}
+
+size_t profiler_ring_get(struct profiler_ring *ring, u8_t *data, size_t size)
+{
+	u32_t idx = atomic_get(&ring->read);
+
+	if (idx == (u32_t)atomic_get(&ring->reserved)) {
+		return 0;
+	}
+
+	volatile u8_t *state = &ring->buf[(idx + HEADER_STATE) & RING_MASK];
+
+	if (*state != RECORD_STATE_COMMITTED) {
+		/* Producer was preempted before completing the record. */
+		return 0;
+	}
+
+	__sync_synchronize();
+
+	size_t len = ring->buf[(idx + HEADER_LEN) & RING_MASK];
+
+	__ASSERT_NO_MSG(len <= size);
+	ring_read(ring, idx + HEADER_SIZE, data, len);
+
+	ring_clear(ring, idx, HEADER_SIZE + len);
+	__sync_synchronize();
+	atomic_set(&ring->read, idx + HEADER_SIZE + len);
+
+	return len;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _PROFILER_NORDIC_RING_H_
+#define _PROFILER_NORDIC_RING_H_
+
+#include <zephyr.h>
+#include <atomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Ring buffer of profiler records.
+ *
+ * Records are written without locks: space is reserved by atomically
+ * moving the reservation index and the record is marked as committed
+ * when it is complete. The buffer is read by one consumer that stops at
+ * the first record that is not committed yet.
+ */
+struct profiler_ring {
+	/** Record storage. */
+	u8_t buf[CONFIG_PROFILER_NORDIC_RING_BUFFER_SIZE];
+
+	/** Index of the first free byte (free running). */
+	atomic_t reserved;
+
+	/** Index of the first unread byte (free running). */
+	atomic_t read;
+
+	/** Number of records dropped because the ring was full. */
+	atomic_t dropped;
+};
+
+
+/** @brief Write a record to the ring.
+ *
+ * The function is lock-free and can be called from any context.
+ *
+ * @param ring Pointer to the ring.
+ * @param data Pointer to the record.
+ * @param len  Length of the record.
+ *
+ * @return True if the record was written, false if it was dropped.
+ */
+bool profiler_ring_put(struct profiler_ring *ring, const u8_t *data,
+		       size_t len);
+
+
+/** @brief Read the oldest committed record from the ring.
+ *
+ * Must be called only by the consumer.
+ *
+ * @param ring Pointer to the ring.
+ * @param data Buffer for the record.
+ * @param size Size of the buffer.
+ *
+ * @return Length of the record or 0 if no committed record is available.
+ */
+size_t profiler_ring_get(struct profiler_ring *ring, u8_t *data, size_t size);
+
+
+/** @brief Get and clear the number of dropped records.
+ *
+ * @param ring Pointer to the ring.
+ *
+ * @return Number of records dropped since the previous call.
+ */
+static inline u32_t profiler_ring_dropped_get(struct profiler_ring *ring)
+{
+	return atomic_set(&ring->dropped, 0);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PROFILER_NORDIC_RING_H_ */
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <misc/util.h>
+#include <profiler.h>
+
+#if defined(CONFIG_CPU_CORTEX_M)
+#include <arch/arm/cortex_m/cmsis.h>
+#endif
+
+#include "profiler_nordic_sampling.h"
+
+
+#define SLOT_CNT	CONFIG_PROFILER_NORDIC_SAMPLING_SLOTS
+#define PROBE_CNT	8
+
+BUILD_ASSERT_MSG((SLOT_CNT & (SLOT_CNT - 1)) == 0,
+		 "Number of sampling slots must be a power of two");
+
+/* Histogram of samples with the same interrupted PC and thread. PC equal to
+ * 0 stands for samples taken when the PC is not known.
+ */
+struct sample_slot {
+	u32_t pc;
+	u32_t thread;
+	u32_t count;
+};
+
+static struct sample_slot slots[SLOT_CNT];
+static u32_t sample_cnt;
+static u32_t lost_cnt;
+
+static struct k_timer sampling_timer;
+static bool sampling_running;
+static atomic_t report_requested;
+static s64_t last_report_time;
+
+static u16_t pc_event_id;
+static u16_t summary_event_id;
+
+
+static u32_t interrupted_pc_get(void)
+{
+#if defined(CONFIG_CPU_CORTEX_M)
+	/* Timer expires in the system clock interrupt. If it preempted
+	 * a thread, the PC is stored in the exception frame on the process
+	 * stack.
+	 */
+	if (!(SCB->ICSR & SCB_ICSR_RETTOBASE_Msk)) {
+		/* Other interrupt was preempted. */
+		return 0;
+	}
+
+	const u32_t *frame = (const u32_t *)__get_PSP();
+
+	return frame[6];
+#else
+	return 0;
+#endif
+}
+
+static void sample_fn(struct k_timer *timer)
+{
+	u32_t pc = interrupted_pc_get();
+	u32_t thread = (u32_t)k_current_get();
+	u32_t hash = (pc >> 1) ^ (thread * 2654435761U);
+
+	sample_cnt++;
+
+	for (size_t i = 0; i < PROBE_CNT; i++) {
+		struct sample_slot *slot = &slots[(hash + i) & (SLOT_CNT - 1)];
+
+		if (slot->count == 0) {
+			slot->pc = pc;
+			slot->thread = thread;
+		}
+
+		if ((slot->pc == pc) && (slot->thread == thread)) {
+			slot->count++;
+			return;
+		}
+	}
+
+	lost_cnt++;
+}
+
+void profiler_sampling_start(void)
+{
+	sampling_running = true;
+	last_report_time = k_uptime_get();
+	k_timer_start(&sampling_timer,
+		      CONFIG_PROFILER_NORDIC_SAMPLING_PERIOD,
+		      CONFIG_PROFILER_NORDIC_SAMPLING_PERIOD);
+}
+
+void profiler_sampling_stop(void)
+{
+	k_timer_stop(&sampling_timer);
+	sampling_running = false;
+}
+
+void profiler_sampling_dump(void)
+{
+	atomic_set(&report_requested, true);
+}
+
+bool profiler_sampling_report_needed(void)
+{
+	if (atomic_get(&report_requested)) {
+		return true;
+	}
+
+	return sampling_running &&
+	       (CONFIG_PROFILER_NORDIC_SAMPLING_REPORT_PERIOD > 0) &&
+	       (k_uptime_get() - last_report_time >=
+		CONFIG_PROFILER_NORDIC_SAMPLING_REPORT_PERIOD);
+}
+
+void profiler_sampling_report(profiler_sampling_send_t send)
+{
+	struct log_event_buf buf;
+
+	atomic_set(&report_requested, false);
+	last_report_time = k_uptime_get();
+
+	for (size_t i = 0; i < ARRAY_SIZE(slots); i++) {
+		/* Slots are updated by the timer interrupt. */
+		int key = irq_lock();
+		struct sample_slot slot = slots[i];
+
+		slots[i].count = 0;
+		irq_unlock(key);
+
+		if (slot.count == 0) {
+			continue;
+		}
+
+		profiler_log_start(&buf);
+		profiler_log_encode_u32(&buf, slot.pc);
+		profiler_log_encode_u32(&buf, slot.thread);
+		profiler_log_encode_u32(&buf, slot.count);
+		send(&buf, pc_event_id);
+	}
+
+	int key = irq_lock();
+	u32_t samples = sample_cnt;
+	u32_t lost = lost_cnt;
+
+	sample_cnt = 0;
+	lost_cnt = 0;
+	irq_unlock(key);
+
+	profiler_log_start(&buf);
+	profiler_log_encode_u32(&buf, samples);
+	profiler_log_encode_u32(&buf, lost);
+	send(&buf, summary_event_id);
+}
+
+void profiler_sampling_init(void)
+{
+	static const char *pc_args[] = {"pc", "thread", "count"};
+	static const enum profiler_arg pc_arg_types[] = {PROFILER_ARG_U32,
+							 PROFILER_ARG_U32,
+							 PROFILER_ARG_U32};
+	static const char *summary_args[] = {"samples", "lost"};
+	static const enum profiler_arg summary_arg_types[] = {PROFILER_ARG_U32,
+							      PROFILER_ARG_U32};
+
+	pc_event_id = profiler_register_event_type("sampling_pc", pc_args,
+						   pc_arg_types,
+						   ARRAY_SIZE(pc_args));
+	summary_event_id = profiler_register_event_type("sampling_summary",
+						summary_args,
+						summary_arg_types,
+						ARRAY_SIZE(summary_args));
+
+	k_timer_init(&sampling_timer, sample_fn, NULL);
+
+	if (IS_ENABLED(CONFIG_PROFILER_NORDIC_SAMPLING_START_ON_SYSTEM_START)) {
+		profiler_sampling_start();
+	}
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _PROFILER_NORDIC_SAMPLING_H_
+#define _PROFILER_NORDIC_SAMPLING_H_
+
+#include <zephyr/types.h>
+#include <profiler.h>
+
+
+/** Function used to send records of the sampling report. */
+typedef void (*profiler_sampling_send_t)(struct log_event_buf *buf,
+					 u16_t event_type_id);
+
+#ifdef CONFIG_PROFILER_NORDIC_SAMPLING
+
+/** Register sampling event types and start sampling if configured. */
+void profiler_sampling_init(void);
+
+/** Check if the sampling report should be sent. */
+bool profiler_sampling_report_needed(void);
+
+/** Send the collected histogram and clear it.
+ *
+ * @param send Function used to send every record of the report.
+ */
+void profiler_sampling_report(profiler_sampling_send_t send);
+
+#else
+
+static inline void profiler_sampling_init(void) {}
+static inline bool profiler_sampling_report_needed(void) {return false; }
+static inline void profiler_sampling_report(profiler_sampling_send_t send) {}
+
+#endif /* CONFIG_PROFILER_NORDIC_SAMPLING */
+
+#endif /* _PROFILER_NORDIC_SAMPLING_H_ */
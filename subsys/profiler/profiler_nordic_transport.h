@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _PROFILER_NORDIC_TRANSPORT_H_
+#define _PROFILER_NORDIC_TRANSPORT_H_
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Channels used by the Nordic profiler protocol.
+ */
+enum profiler_transport_channel {
+	/** Binary event records. */
+	PROFILER_TRANSPORT_CHANNEL_DATA,
+
+	/** Event type descriptions. */
+	PROFILER_TRANSPORT_CHANNEL_INFO,
+};
+
+
+/** @brief Initialize the transport.
+ *
+ * @retval 0 If the operation was successful.
+ */
+int profiler_transport_init(void);
+
+
+/** @brief Send data over the given channel.
+ *
+ * The function is called from the threads of the profiler and must
+ * serialize the data sent by them. Data is either sent entirely or
+ * dropped.
+ *
+ * @param channel Channel used to send the data.
+ * @param data    Pointer to the data.
+ * @param len     Length of the data.
+ *
+ * @return Number of bytes sent.
+ */
+size_t profiler_transport_send(enum profiler_transport_channel channel,
+			       const u8_t *data, size_t len);
+
+
+/** @brief Read a command sent by the host.
+ *
+ * The function does not block.
+ *
+ * @param cmd Pointer to the command byte.
+ *
+ * @return Number of bytes read (0 or 1).
+ */
+size_t profiler_transport_command_read(u8_t *cmd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PROFILER_NORDIC_TRANSPORT_H_ */
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "profiler_nordic_transport.h"
+
+/* Every channel is written to a separate host file. The files can also be
+ * named pipes read by the host tools while the application is running.
+ * Commands are read from a file or a named pipe. A regular file can be
+ * used to script the commands, for example INFO followed by START.
+ */
+
+static int up_fds[] = {
+	[PROFILER_TRANSPORT_CHANNEL_DATA] = -1,
+	[PROFILER_TRANSPORT_CHANNEL_INFO] = -1,
+};
+static int command_fd = -1;
+
+/* Writing to a file can block, so interrupts are not locked. */
+static K_MUTEX_DEFINE(write_lock);
+
+
+int profiler_transport_init(void)
+{
+	/* Opening a named pipe for writing blocks until the host opens it
+	 * for reading.
+	 */
+	up_fds[PROFILER_TRANSPORT_CHANNEL_DATA] =
+		open(CONFIG_PROFILER_NORDIC_FILE_DATA_PATH,
+		     O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	up_fds[PROFILER_TRANSPORT_CHANNEL_INFO] =
+		open(CONFIG_PROFILER_NORDIC_FILE_INFO_PATH,
+		     O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+	if ((up_fds[PROFILER_TRANSPORT_CHANNEL_DATA] < 0) ||
+	    (up_fds[PROFILER_TRANSPORT_CHANNEL_INFO] < 0)) {
+		return -EIO;
+	}
+
+	/* Commands are optional, events can be logged from system start. */
+	command_fd = open(CONFIG_PROFILER_NORDIC_FILE_COMMAND_PATH,
+			  O_RDONLY | O_NONBLOCK);
+
+	return 0;
+}
+
+size_t profiler_transport_send(enum profiler_transport_channel channel,
+			       const u8_t *data, size_t len)
+{
+	__ASSERT_NO_MSG(channel < ARRAY_SIZE(up_fds));
+
+	size_t sent = 0;
+
+	k_mutex_lock(&write_lock, K_FOREVER);
+
+	/* Host decoder loses sync if only a part of the data is written. */
+	while (sent < len) {
+		ssize_t ret = write(up_fds[channel], data + sent, len - sent);
+
+		if (ret <= 0) {
+			break;
+		}
+		sent += ret;
+	}
+
+	k_mutex_unlock(&write_lock);
+
+	/* Data already written cannot be taken back, so it is reported as
+	 * dropped and counted as lost.
+	 */
+	return (sent == len) ? len : 0;
+}
+
+size_t profiler_transport_command_read(u8_t *cmd)
+{
+	if (command_fd < 0) {
+		return 0;
+	}
+
+	ssize_t ret = read(command_fd, cmd, sizeof(*cmd));
+
+	return (ret > 0) ? ret : 0;
+}
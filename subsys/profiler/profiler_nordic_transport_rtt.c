@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <SEGGER_RTT.h>
+
+#include "profiler_nordic_transport.h"
+
+
+static u8_t buffer_data[CONFIG_PROFILER_NORDIC_DATA_BUFFER_SIZE];
+static u8_t buffer_info[CONFIG_PROFILER_NORDIC_INFO_BUFFER_SIZE];
+static u8_t buffer_commands[CONFIG_PROFILER_NORDIC_COMMAND_BUFFER_SIZE];
+
+static const unsigned int up_channels[] = {
+	[PROFILER_TRANSPORT_CHANNEL_DATA] =
+		CONFIG_PROFILER_NORDIC_RTT_CHANNEL_DATA,
+	[PROFILER_TRANSPORT_CHANNEL_INFO] =
+		CONFIG_PROFILER_NORDIC_RTT_CHANNEL_INFO,
+};
+
+
+int profiler_transport_init(void)
+{
+	int ret;
+
+	ret = SEGGER_RTT_ConfigUpBuffer(
+		CONFIG_PROFILER_NORDIC_RTT_CHANNEL_DATA,
+		"Nordic profiler data",
+		buffer_data,
+		CONFIG_PROFILER_NORDIC_DATA_BUFFER_SIZE,
+		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+	if (ret < 0) {
+		return -EIO;
+	}
+
+	ret = SEGGER_RTT_ConfigUpBuffer(
+		CONFIG_PROFILER_NORDIC_RTT_CHANNEL_INFO,
+		"Nordic profiler info",
+		buffer_info,
+		CONFIG_PROFILER_NORDIC_INFO_BUFFER_SIZE,
+		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+	if (ret < 0) {
+		return -EIO;
+	}
+
+	ret = SEGGER_RTT_ConfigDownBuffer(
+		CONFIG_PROFILER_NORDIC_RTT_CHANNEL_COMMANDS,
+		"Nordic profiler command",
+		buffer_commands,
+		CONFIG_PROFILER_NORDIC_COMMAND_BUFFER_SIZE,
+		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+	if (ret < 0) {
+		return -EIO;
+	}
+
+	return 0;
+}
+
+size_t profiler_transport_send(enum profiler_transport_channel channel,
+			       const u8_t *data, size_t len)
+{
+	__ASSERT_NO_MSG(channel < ARRAY_SIZE(up_channels));
+
+	int key = irq_lock();
+	size_t sent = SEGGER_RTT_WriteNoLock(up_channels[channel], data, len);
+
+	irq_unlock(key);
+
+	return sent;
+}
+
+size_t profiler_transport_command_read(u8_t *cmd)
+{
+	return SEGGER_RTT_Read(CONFIG_PROFILER_NORDIC_RTT_CHANNEL_COMMANDS,
+			       cmd, sizeof(*cmd));
+}
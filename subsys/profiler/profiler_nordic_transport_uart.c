@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <uart.h>
+#include <ring_buffer.h>
+
+#include "profiler_nordic_transport.h"
+
+/* All channels share one UART. Every chunk of data is sent as a frame
+ * consisting of the channel ID, the length of the data and the data.
+ */
+struct frame_header {
+	u8_t channel;
+	u8_t len;
+} __packed;
+
+#define RX_BUF_SIZE	4
+#define RX_TIMEOUT	10 /* ms */
+
+
+RING_BUF_DECLARE(tx_buf, CONFIG_PROFILER_NORDIC_DATA_BUFFER_SIZE);
+RING_BUF_DECLARE(cmd_buf, CONFIG_PROFILER_NORDIC_COMMAND_BUFFER_SIZE);
+
+static struct device *uart_dev;
+static size_t tx_len;
+
+static u8_t rx_bufs[2][RX_BUF_SIZE];
+static u8_t rx_buf_idx;
+
+
+static void tx_start(void)
+{
+	u8_t *data;
+
+	if (tx_len) {
+		/* Transmission in progress. */
+		return;
+	}
+
+	tx_len = ring_buf_get_claim(&tx_buf, &data,
+				    CONFIG_PROFILER_NORDIC_DATA_BUFFER_SIZE);
+
+	if (tx_len && uart_tx(uart_dev, data, tx_len, K_FOREVER)) {
+		/* Data is dropped if UART cannot transmit it. */
+		ring_buf_get_finish(&tx_buf, tx_len);
+		tx_len = 0;
+	}
+}
+
+static void rx_enable(void)
+{
+	rx_buf_idx = 0;
+
+	int err = uart_rx_enable(uart_dev, rx_bufs[rx_buf_idx],
+				 sizeof(rx_bufs[rx_buf_idx]), RX_TIMEOUT);
+
+	__ASSERT_NO_MSG(!err);
+	ARG_UNUSED(err);
+}
+
+static void uart_cb(struct uart_event *evt, void *user_data)
+{
+	switch (evt->type) {
+	case UART_TX_DONE:
+	case UART_TX_ABORTED:
+	{
+		int key = irq_lock();
+
+		ring_buf_get_finish(&tx_buf, tx_len);
+		tx_len = 0;
+		tx_start();
+
+		irq_unlock(key);
+		break;
+	}
+
+	case UART_RX_RDY:
+		/* Commands not fitting in the buffer are dropped. */
+		ring_buf_put(&cmd_buf, evt->data.rx.buf + evt->data.rx.offset,
+			     evt->data.rx.len);
+		break;
+
+	case UART_RX_BUF_REQUEST:
+		rx_buf_idx = (rx_buf_idx + 1) % ARRAY_SIZE(rx_bufs);
+		uart_rx_buf_rsp(uart_dev, rx_bufs[rx_buf_idx],
+				sizeof(rx_bufs[rx_buf_idx]));
+		break;
+
+	case UART_RX_DISABLED:
+		rx_enable();
+		break;
+
+	default:
+		break;
+	}
+}
+
+int profiler_transport_init(void)
+{
+	uart_dev = device_get_binding(CONFIG_PROFILER_NORDIC_UART_DEV_NAME);
+	if (!uart_dev) {
+		return -ENXIO;
+	}
+
+	int err = uart_callback_set(uart_dev, uart_cb, NULL);
+
+	if (err) {
+		return err;
+	}
+
+	rx_enable();
+
+	return 0;
+}
+
+size_t profiler_transport_send(enum profiler_transport_channel channel,
+			       const u8_t *data, size_t len)
+{
+	__ASSERT_NO_MSG(len <= UCHAR_MAX);
+
+	struct frame_header hdr = {
+		.channel = channel,
+		.len = len,
+	};
+
+	int key = irq_lock();
+
+	if (ring_buf_space_get(&tx_buf) < sizeof(hdr) + len) {
+		irq_unlock(key);
+		return 0;
+	}
+
+	ring_buf_put(&tx_buf, (u8_t *)&hdr, sizeof(hdr));
+	ring_buf_put(&tx_buf, data, len);
+
+	tx_start();
+
+	irq_unlock(key);
+
+	return len;
+}
+
+size_t profiler_transport_command_read(u8_t *cmd)
+{
+	int key = irq_lock();
+	size_t len = ring_buf_get(&cmd_buf, cmd, sizeof(*cmd));
+
+	irq_unlock(key);
+
+	return len;
+}
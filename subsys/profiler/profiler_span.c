@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <string.h>
+#include <zephyr.h>
+#include <spinlock.h>
+#include <misc/util.h>
+#include <profiler.h>
+
+
+enum span_state {
+	SPAN_STATE_BEGIN,
+	SPAN_STATE_END
+};
+
+struct span_type {
+	const char *name;
+	u16_t event_type_id;
+};
+
+struct span_frame {
+	u16_t span_id;
+	u32_t start_cycles;
+};
+
+/* Stack of spans open in a thread. The slot is taken by a thread when it
+ * begins its outermost span and released when the span ends.
+ */
+struct span_stack {
+	atomic_t owner;
+	u8_t depth;
+	struct span_frame frames[CONFIG_PROFILER_SPAN_STACK_DEPTH];
+};
+
+struct span_stats {
+	u32_t count;
+	u32_t min;
+	u32_t max;
+	u64_t sum;
+};
+
+static struct span_type span_types[CONFIG_PROFILER_SPAN_MAX_CNT];
+static ATOMIC_DEFINE(registered_spans, CONFIG_PROFILER_SPAN_MAX_CNT);
+static atomic_t span_cnt;
+
+static struct span_stack span_stacks[CONFIG_PROFILER_SPAN_THREAD_CNT];
+
+#ifdef CONFIG_PROFILER_SPAN_STATS
+static struct span_stats span_stats[CONFIG_PROFILER_SPAN_MAX_CNT];
+static struct k_spinlock stats_lock;
+#endif
+
+
+static bool span_is_registered(u16_t span_id)
+{
+	return (span_id < CONFIG_PROFILER_SPAN_MAX_CNT) &&
+	       atomic_test_bit(registered_spans, span_id);
+}
+
+static struct span_stack *span_stack_get(bool take)
+{
+	atomic_val_t thread = (atomic_val_t)k_current_get();
+
+	for (size_t i = 0; i < ARRAY_SIZE(span_stacks); i++) {
+		if (atomic_get(&span_stacks[i].owner) == thread) {
+			return &span_stacks[i];
+		}
+	}
+
+	if (!take) {
+		return NULL;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(span_stacks); i++) {
+		if (atomic_cas(&span_stacks[i].owner, 0, thread)) {
+			return &span_stacks[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void span_log(u16_t span_id, enum span_state state, u8_t depth)
+{
+	u16_t event_type_id = span_types[span_id].event_type_id;
+
+	if (!is_profiling_enabled(event_type_id)) {
+		return;
+	}
+
+	struct log_event_buf buf;
+
+	profiler_log_start(&buf);
+	profiler_log_encode_u32(&buf, state);
+	profiler_log_encode_u32(&buf, depth);
+	profiler_log_add_mem_address(&buf, k_current_get());
+	profiler_log_send(&buf, event_type_id);
+}
+
+static void span_stats_update(u16_t span_id, u32_t cycles)
+{
+#ifdef CONFIG_PROFILER_SPAN_STATS
+	struct span_stats *stats = &span_stats[span_id];
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	if ((stats->count == 0) || (cycles < stats->min)) {
+		stats->min = cycles;
+	}
+	if (cycles > stats->max) {
+		stats->max = cycles;
+	}
+	stats->sum += cycles;
+	stats->count++;
+
+	k_spin_unlock(&stats_lock, key);
+#endif
+}
+
+u16_t profiler_span_register(const char *name)
+{
+	static const char *args[] = {"state", "depth", "thread"};
+	static const enum profiler_arg arg_types[] = {PROFILER_ARG_U8,
+						      PROFILER_ARG_U8,
+						      PROFILER_ARG_U32};
+	atomic_val_t span_id;
+
+	do {
+		span_id = atomic_get(&span_cnt);
+		if (span_id >= CONFIG_PROFILER_SPAN_MAX_CNT) {
+			__ASSERT(false, "Too many span types registered");
+			return PROFILER_INVALID_SPAN_ID;
+		}
+	} while (!atomic_cas(&span_cnt, span_id, span_id + 1));
+
+	span_types[span_id].name = name;
+	span_types[span_id].event_type_id =
+		profiler_register_event_type(name, args, arg_types,
+					     ARRAY_SIZE(args));
+
+	/* Memory barrier to make sure that data is visible
+	 * before the span type is published
+	 */
+	__sync_synchronize();
+	atomic_set_bit(registered_spans, span_id);
+
+	return span_id;
+}
+
+const char *profiler_span_name_get(u16_t span_id)
+{
+	if (!span_is_registered(span_id)) {
+		return NULL;
+	}
+
+	return span_types[span_id].name;
+}
+
+void profiler_span_begin(u16_t span_id)
+{
+	__ASSERT_NO_MSG(!k_is_in_isr());
+	__ASSERT_NO_MSG(span_is_registered(span_id));
+
+	struct span_stack *stack = span_stack_get(true);
+
+	if (!stack) {
+		__ASSERT(false, "No free span stack");
+		return;
+	}
+
+	if (stack->depth == ARRAY_SIZE(stack->frames)) {
+		__ASSERT(false, "Span stack overflow");
+		return;
+	}
+
+	struct span_frame *frame = &stack->frames[stack->depth];
+
+	span_log(span_id, SPAN_STATE_BEGIN, stack->depth);
+
+	frame->span_id = span_id;
+	stack->depth++;
+
+	/* Measure from the last moment to skip the logging time. */
+	frame->start_cycles = k_cycle_get_32();
+}
+
+void profiler_span_end(u16_t span_id)
+{
+	u32_t end_cycles = k_cycle_get_32();
+
+	__ASSERT_NO_MSG(!k_is_in_isr());
+
+	struct span_stack *stack = span_stack_get(false);
+
+	if (!stack || (stack->depth == 0)) {
+		__ASSERT(false, "Span not begun");
+		return;
+	}
+
+	/* Spans not ended by the caller are ended together with their
+	 * parent.
+	 */
+	while (stack->depth > 0) {
+		stack->depth--;
+
+		const struct span_frame *frame = &stack->frames[stack->depth];
+
+		span_stats_update(frame->span_id,
+				  end_cycles - frame->start_cycles);
+		span_log(frame->span_id, SPAN_STATE_END, stack->depth);
+
+		if (frame->span_id == span_id) {
+			break;
+		}
+
+		__ASSERT(false, "Span ended out of order");
+	}
+
+	if (stack->depth == 0) {
+		atomic_set(&stack->owner, 0);
+	}
+}
+
+#ifdef CONFIG_PROFILER_SPAN_STATS
+int profiler_span_stats_get(u16_t span_id, struct profiler_span_stats *stats)
+{
+	if (!span_is_registered(span_id)) {
+		return -ENOENT;
+	}
+
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+	struct span_stats s = span_stats[span_id];
+
+	k_spin_unlock(&stats_lock, key);
+
+	stats->count = s.count;
+	stats->min = SYS_CLOCK_HW_CYCLES_TO_NS64(s.min) / NSEC_PER_USEC;
+	stats->max = SYS_CLOCK_HW_CYCLES_TO_NS64(s.max) / NSEC_PER_USEC;
+	stats->mean = (s.count > 0) ?
+		SYS_CLOCK_HW_CYCLES_TO_NS64(s.sum / s.count) / NSEC_PER_USEC : 0;
+
+	return 0;
+}
+
+void profiler_span_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	memset(span_stats, 0, sizeof(span_stats));
+
+	k_spin_unlock(&stats_lock, key);
+}
+#endif /* CONFIG_PROFILER_SPAN_STATS */
@@ -8,16 +8,20 @@
 #include <profiler.h>
 #include <kernel_structs.h>
 
+/* Descriptions are stored statically for every event type. */
+#define SYSVIEW_MAX_NUMBER_OF_CUSTOM_EVENTS 32
 
-/* By default, when there is no shell, all events are profiled. */
-#ifndef CONFIG_SHELL
-u32_t profiler_enabled_events = 0xffffffff;
-#endif
+BUILD_ASSERT_MSG(CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS <=
+		 SYSVIEW_MAX_NUMBER_OF_CUSTOM_EVENTS,
+		 "Too many event types for the SysView profiler");
+
+ATOMIC_DEFINE(profiler_enabled_events, CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS);
 
 static char descr[CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS]
 		 [CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS];
+static const char *names[CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS];
 
-u8_t profiler_num_events;
+atomic_t profiler_num_events;
 
 static char *arg_types_encodings[] = {
 					"%u",	/* u8_t */
@@ -74,9 +78,13 @@ void profiler_term(void)
 {
 }
 
-const char *profiler_get_event_descr(size_t profiler_event_id)
+const char *profiler_get_event_name(size_t profiler_event_id)
 {
-	return descr[profiler_event_id];
+	if (profiler_event_id >= events.NumEvents) {
+		return NULL;
+	}
+
+	return names[profiler_event_id];
 }
 
 u16_t profiler_register_event_type(const char *name, const char **args,
@@ -89,6 +97,14 @@ u16_t profiler_register_event_type(const char *name, const char **args,
 	k_sched_lock();
 	u32_t ne = events.NumEvents;
 
+	if (ne >= CONFIG_MAX_NUMBER_OF_CUSTOM_EVENTS) {
+		k_sched_unlock();
+		__ASSERT(false, "Too many event types registered");
+		return PROFILER_INVALID_EVENT_TYPE_ID;
+	}
+
+	names[ne] = name;
+
 	size_t temp = snprintf(descr[ne],
 			CONFIG_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS,
 			"%u %s", ne, name);
@@ -111,10 +127,16 @@ u16_t profiler_register_event_type(const char *name, const char **args,
 	 * before being accessed
 	 */
 	__DMB();
+
+	/* By default, when there is no shell, all events are profiled. */
+	if (!IS_ENABLED(CONFIG_SHELL)) {
+		atomic_set_bit(profiler_enabled_events, ne);
+	}
+
 	events.NumEvents++;
-	profiler_num_events = events.NumEvents;
+	atomic_set(&profiler_num_events, events.NumEvents);
 	k_sched_unlock();
-	return events.EventOffset + ne;
+	return ne;
 }
 
 void profiler_log_start(struct log_event_buf *buf)
@@ -145,6 +167,7 @@ void profiler_log_add_mem_address(struct log_event_buf *buf,
 
 void profiler_log_send(struct log_event_buf *buf, u16_t event_type_id)
 {
+	/* Event type IDs are local to the module. */
 	SEGGER_SYSVIEW_SendPacket(buf->payload_start, buf->payload,
-				  event_type_id);
+				  events.EventOffset + event_type_id);
 }
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include "corpus.h"
+
+char bench_corpus[] =
+	"+CEREG: 2,5,\"0B1A\",\"0012BEEF\",7\r\n"
+	"OK\r\n"
+	"+CEREG: 5,\"0B1A\",\"0012BEEF\",7,,,\"00000110\",\"11100000\"\r\n"
+	"+CEREG: 2,\"0B1A\",\"0012BEEF\",7\r\n"
+	"%CESQ: 54,2,17,3\r\n"
+	"%CESQ: 61,2,19,3\r\n"
+	"+CESQ: 99,99,255,255,31,62\r\n"
+	"OK\r\n"
+	"+CGDCONT: 0,\"IP\",\"ibasis.iot\",\"10.160.38.106\",0,0\r\n"
+	"OK\r\n"
+	"+COPS: 0,2,\"24201\",7\r\n"
+	"OK\r\n"
+	"%XSYSTEMMODE: 1,0,0,0\r\n"
+	"OK\r\n"
+	"%XCBAND: 20\r\n"
+	"OK\r\n"
+	"%XVBAT: 4958\r\n"
+	"OK\r\n"
+	"%XTEMP: 1,24\r\n"
+	"OK\r\n"
+	"+CRSM: 144,0,\"98101430121181157002\"\r\n"
+	"OK\r\n"
+	"+CGSN: \"352656100367872\"\r\n"
+	"OK\r\n"
+	"%XSIM: 1\r\n"
+	"+CFUN: 1\r\n"
+	"OK\r\n"
+	"%XMONITOR: 1,\"\",\"\",\"24201\",\"0B1A\",9,20,\"0012BEEF\",334,6400,"
+	"53,24,\"\",\"11100000\",\"00011110\"\r\n"
+	"OK\r\n"
+	"+CME ERROR: 514\r\n";
+
+/* Terminating null is not a part of the corpus. */
+const size_t bench_corpus_size = sizeof(bench_corpus) - 1;
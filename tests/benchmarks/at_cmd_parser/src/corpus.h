@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _CORPUS_H_
+#define _CORPUS_H_
+
+#include <zephyr/types.h>
+
+/* Responses and notifications received from the nRF9160 modem, every line
+ * terminated with CRLF.
+ */
+extern char bench_corpus[];
+extern const size_t bench_corpus_size;
+
+#endif /* _CORPUS_H_ */
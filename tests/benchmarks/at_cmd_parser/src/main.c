@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <misc/printk.h>
+#include <at_cmd_parser.h>
+#include <at_params.h>
+
+#include "corpus.h"
+
+#define PARAM_CNT 16
+#define ARENA_SIZE 128
+#define LINE_BUF_SIZE 128
+#define LINE_CNT_MAX 64
+
+
+static struct at_param_list param_list;
+static char *lines[LINE_CNT_MAX];
+static size_t line_cnt;
+static size_t handled_cnt;
+
+
+static u64_t cycles_to_ns(u32_t cycles)
+{
+	return MAX(SYS_CLOCK_HW_CYCLES_TO_NS64(cycles), 1);
+}
+
+static int lines_prepare(void)
+{
+	char *line = bench_corpus;
+	char *end = bench_corpus + bench_corpus_size;
+
+	while (line < end) {
+		if (line_cnt == ARRAY_SIZE(lines)) {
+			return -ENOMEM;
+		}
+
+		/* Parameters of a response follow the colon. The parser
+		 * stops at the end of the line.
+		 */
+		char *line_end = strchr(line, '\r');
+		char *colon = memchr(line, ':', line_end - line);
+
+		lines[line_cnt++] = (colon != NULL) ? (colon + 1) : line;
+		line = line_end + strlen("\r\n");
+	}
+
+	return 0;
+}
+
+static int bench_params_run(u32_t *cycles)
+{
+	u32_t start = k_cycle_get_32();
+
+	for (size_t i = 0; i < CONFIG_BENCH_ITERATION_CNT; i++) {
+		for (size_t j = 0; j < line_cnt; j++) {
+			int err = at_parser_params_from_str(lines[j],
+							    &param_list);
+
+			if (err) {
+				return err;
+			}
+		}
+	}
+
+	*cycles = k_cycle_get_32() - start;
+
+	return 0;
+}
+
+static void bench_handler(const char *prefix, struct at_param_list *list,
+			  void *user_data)
+{
+	ARG_UNUSED(prefix);
+	ARG_UNUSED(list);
+	ARG_UNUSED(user_data);
+
+	handled_cnt++;
+}
+
+static int bench_stream_run(u32_t *cycles)
+{
+	/* Sorted by prefix. */
+	static const struct at_parser_prefix_handler handlers[] = {
+		{ "%CESQ", bench_handler },
+		{ "%XCBAND", bench_handler },
+		{ "%XMONITOR", bench_handler },
+		{ "%XSIM", bench_handler },
+		{ "%XSYSTEMMODE", bench_handler },
+		{ "%XTEMP", bench_handler },
+		{ "%XVBAT", bench_handler },
+		{ "+CEREG", bench_handler },
+		{ "+CESQ", bench_handler },
+		{ "+CFUN", bench_handler },
+		{ "+CGDCONT", bench_handler },
+		{ "+CGSN", bench_handler },
+		{ "+CME ERROR", bench_handler },
+		{ "+COPS", bench_handler },
+		{ "+CRSM", bench_handler },
+		{ "OK", bench_handler },
+	};
+	static char line_buf[LINE_BUF_SIZE];
+	struct at_parser_stream stream;
+
+	int err = at_parser_stream_init(&stream, &param_list, handlers,
+					ARRAY_SIZE(handlers), line_buf,
+					sizeof(line_buf), NULL);
+
+	if (err) {
+		return err;
+	}
+
+	u32_t start = k_cycle_get_32();
+
+	for (size_t i = 0; i < CONFIG_BENCH_ITERATION_CNT; i++) {
+		err = at_parser_stream_feed(&stream, bench_corpus,
+					    bench_corpus_size);
+
+		if (err) {
+			return err;
+		}
+	}
+
+	*cycles = k_cycle_get_32() - start;
+
+	if (handled_cnt != line_cnt * CONFIG_BENCH_ITERATION_CNT) {
+		/* Every line of the corpus has a handler. */
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static void result_print(const char *mode, u32_t cycles)
+{
+	u64_t ns = cycles_to_ns(cycles);
+	u64_t bytes = (u64_t)bench_corpus_size * CONFIG_BENCH_ITERATION_CNT;
+	u64_t line_total = (u64_t)line_cnt * CONFIG_BENCH_ITERATION_CNT;
+
+	printk("%s,%s,%u,%zu,%zu,%u,%u,%u\n",
+	       mode,
+	       IS_ENABLED(CONFIG_BENCH_ARENA) ? "arena" : "heap",
+	       CONFIG_BENCH_ITERATION_CNT,
+	       bench_corpus_size,
+	       line_cnt,
+	       (u32_t)(bytes * NSEC_PER_SEC / ns),
+	       (u32_t)(line_total * NSEC_PER_SEC / ns),
+	       (u32_t)(cycles / line_total));
+}
+
+void main(void)
+{
+	int err;
+
+	if (IS_ENABLED(CONFIG_BENCH_ARENA)) {
+		err = at_params_list_arena_init(&param_list, PARAM_CNT,
+						ARENA_SIZE);
+	} else {
+		err = at_params_list_init(&param_list, PARAM_CNT);
+	}
+
+	if (!err) {
+		err = lines_prepare();
+	}
+
+	if (err) {
+		printk("Benchmark not initialized (err: %d)\n", err);
+		return;
+	}
+
+	printk("mode,strings,iterations,corpus_bytes,corpus_lines,"
+	       "bytes_per_s,lines_per_s,cycles_per_line\n");
+
+	u32_t cycles;
+
+	err = bench_params_run(&cycles);
+	if (err) {
+		printk("Benchmark failed (err: %d)\n", err);
+		return;
+	}
+	result_print("params", cycles);
+
+	err = bench_stream_run(&cycles);
+	if (err) {
+		printk("Benchmark failed (err: %d)\n", err);
+		return;
+	}
+	result_print("stream", cycles);
+}
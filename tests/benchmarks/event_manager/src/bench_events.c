@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include "bench_events.h"
+
+
+static void profile_bench_event(struct log_event_buf *buf,
+				const struct event_header *eh)
+{
+	profiler_log_encode_u32(buf, bench_data_get(eh)->timestamp);
+}
+
+#define BENCH_EVENT_DEFINE(idx)						\
+	EVENT_INFO_DEFINE(BENCH_EVENT(idx),				\
+			  ENCODE(PROFILER_ARG_U32),			\
+			  ENCODE("timestamp"),				\
+			  profile_bench_event);				\
+	EVENT_TYPE_DEFINE(BENCH_EVENT(idx),				\
+			  false,					\
+			  NULL,						\
+			  &_CONCAT(BENCH_EVENT(idx), _info),		\
+			  EVENT_DELIVERY_CLASS(BENCH_DELIVERY_CLASS));	\
+									\
+	static struct event_header *_CONCAT(bench_new_, idx)(void)	\
+	{								\
+		return &_CONCAT(new_, BENCH_EVENT(idx))()->header;	\
+	}
+
+BENCH_REPEAT(CONFIG_BENCH_EVENT_TYPE_CNT, BENCH_EVENT_DEFINE)
+
+#define BENCH_NEW_FN(idx) _CONCAT(bench_new_, idx),
+
+static struct event_header *(*const bench_new_fns[])(void) = {
+	BENCH_REPEAT(CONFIG_BENCH_EVENT_TYPE_CNT, BENCH_NEW_FN)
+};
+
+
+struct event_header *bench_event_new(size_t type_idx)
+{
+	__ASSERT_NO_MSG(type_idx < ARRAY_SIZE(bench_new_fns));
+
+	return bench_new_fns[type_idx]();
+}
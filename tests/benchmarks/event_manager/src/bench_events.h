@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _BENCH_EVENTS_H_
+#define _BENCH_EVENTS_H_
+
+/**
+ * @brief Benchmark Events
+ * @defgroup bench_events Benchmark Events
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Macros repeating the given macro for indexes from 0 to n - 1. */
+#define BENCH_REPEAT(n, macro) _CONCAT(_BENCH_REPEAT_, n)(macro)
+
+#define _BENCH_REPEAT_1(m)  m(0)
+#define _BENCH_REPEAT_2(m)  _BENCH_REPEAT_1(m)  m(1)
+#define _BENCH_REPEAT_3(m)  _BENCH_REPEAT_2(m)  m(2)
+#define _BENCH_REPEAT_4(m)  _BENCH_REPEAT_3(m)  m(3)
+#define _BENCH_REPEAT_5(m)  _BENCH_REPEAT_4(m)  m(4)
+#define _BENCH_REPEAT_6(m)  _BENCH_REPEAT_5(m)  m(5)
+#define _BENCH_REPEAT_7(m)  _BENCH_REPEAT_6(m)  m(6)
+#define _BENCH_REPEAT_8(m)  _BENCH_REPEAT_7(m)  m(7)
+#define _BENCH_REPEAT_9(m)  _BENCH_REPEAT_8(m)  m(8)
+#define _BENCH_REPEAT_10(m) _BENCH_REPEAT_9(m)  m(9)
+#define _BENCH_REPEAT_11(m) _BENCH_REPEAT_10(m) m(10)
+#define _BENCH_REPEAT_12(m) _BENCH_REPEAT_11(m) m(11)
+#define _BENCH_REPEAT_13(m) _BENCH_REPEAT_12(m) m(12)
+#define _BENCH_REPEAT_14(m) _BENCH_REPEAT_13(m) m(13)
+#define _BENCH_REPEAT_15(m) _BENCH_REPEAT_14(m) m(14)
+#define _BENCH_REPEAT_16(m) _BENCH_REPEAT_15(m) m(15)
+
+#define BENCH_EVENT(idx) _CONCAT(bench_event_, idx)
+
+#if CONFIG_BENCH_DELIVERY_REALTIME
+#define BENCH_DELIVERY_CLASS EVENT_DELIVERY_REALTIME
+#elif CONFIG_BENCH_DELIVERY_BULK
+#define BENCH_DELIVERY_CLASS EVENT_DELIVERY_BULK
+#else
+#define BENCH_DELIVERY_CLASS EVENT_DELIVERY_DEFAULT
+#endif
+
+/* All benchmark event types share the same layout. */
+struct bench_data {
+	u32_t timestamp;
+	u8_t payload[CONFIG_BENCH_PAYLOAD_SIZE];
+};
+
+#define BENCH_EVENT_DECLARE(idx)				\
+	struct BENCH_EVENT(idx) {				\
+		struct event_header header;			\
+								\
+		struct bench_data data;				\
+	};							\
+	EVENT_TYPE_DECLARE(BENCH_EVENT(idx));
+
+BENCH_REPEAT(CONFIG_BENCH_EVENT_TYPE_CNT, BENCH_EVENT_DECLARE)
+
+/** Size of a benchmark event. */
+#define BENCH_EVENT_SIZE sizeof(struct bench_event_0)
+
+/** Allocate a benchmark event of the given type. */
+struct event_header *bench_event_new(size_t type_idx);
+
+/** Get data of a benchmark event. */
+static inline struct bench_data *bench_data_get(const struct event_header *eh)
+{
+	return &CONTAINER_OF(eh, struct bench_event_0, header)->data;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _BENCH_EVENTS_H_ */
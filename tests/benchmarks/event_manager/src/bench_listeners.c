@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+
+#include "bench_events.h"
+#include "bench_listeners.h"
+
+
+/* Macros repeating the given macro for subscriber indexes. They are separate
+ * from BENCH_REPEAT to allow nesting.
+ */
+#define SUBS_REPEAT(n, macro, arg) _CONCAT(_SUBS_REPEAT_, n)(macro, arg)
+
+#define _SUBS_REPEAT_1(m, a) m(0, a)
+#define _SUBS_REPEAT_2(m, a) _SUBS_REPEAT_1(m, a) m(1, a)
+#define _SUBS_REPEAT_3(m, a) _SUBS_REPEAT_2(m, a) m(2, a)
+#define _SUBS_REPEAT_4(m, a) _SUBS_REPEAT_3(m, a) m(3, a)
+#define _SUBS_REPEAT_5(m, a) _SUBS_REPEAT_4(m, a) m(4, a)
+#define _SUBS_REPEAT_6(m, a) _SUBS_REPEAT_5(m, a) m(5, a)
+#define _SUBS_REPEAT_7(m, a) _SUBS_REPEAT_6(m, a) m(6, a)
+#define _SUBS_REPEAT_8(m, a) _SUBS_REPEAT_7(m, a) m(7, a)
+
+#define EARLY_LISTENER(idx) _CONCAT(bench_early, idx)
+#define EARLY_HANDLER(idx) _CONCAT(_EARLY_HANDLER_, idx)
+#define NORMAL_LISTENER(idx) _CONCAT(bench_normal, idx)
+
+
+static struct bench_result *result;
+static u32_t expected_cnt;
+static struct k_sem *done_sem;
+static volatile u8_t sink;
+
+
+static bool first_handler(const struct event_header *eh)
+{
+	u32_t latency = k_cycle_get_32() - bench_data_get(eh)->timestamp;
+
+	if (result->sample_cnt < ARRAY_SIZE(result->latency)) {
+		result->latency[result->sample_cnt] = latency;
+		result->sample_cnt++;
+	}
+
+	return false;
+}
+
+static bool bench_handler(const struct event_header *eh)
+{
+	if (CONFIG_BENCH_PAYLOAD_SIZE > 0) {
+		sink = bench_data_get(eh)->payload[0];
+	}
+
+	return false;
+}
+
+static bool final_handler(const struct event_header *eh)
+{
+	result->handled_cnt++;
+
+	if (result->handled_cnt == expected_cnt) {
+		k_sem_give(done_sem);
+	}
+
+	return false;
+}
+
+/* First early subscriber measures the latency. */
+#define _EARLY_HANDLER_0 first_handler
+#define _EARLY_HANDLER_1 bench_handler
+#define _EARLY_HANDLER_2 bench_handler
+#define _EARLY_HANDLER_3 bench_handler
+#define _EARLY_HANDLER_4 bench_handler
+#define _EARLY_HANDLER_5 bench_handler
+#define _EARLY_HANDLER_6 bench_handler
+#define _EARLY_HANDLER_7 bench_handler
+
+#define LISTENERS_DEFINE(idx, _)					\
+	EVENT_LISTENER(EARLY_LISTENER(idx), EARLY_HANDLER(idx));	\
+	EVENT_LISTENER(NORMAL_LISTENER(idx), bench_handler);
+
+SUBS_REPEAT(CONFIG_BENCH_SUBSCRIBER_CNT, LISTENERS_DEFINE, _)
+
+EVENT_LISTENER(bench_final, final_handler);
+
+#define SUBSCRIBE(idx, ename)						\
+	EVENT_SUBSCRIBE_EARLY(EARLY_LISTENER(idx), ename);		\
+	EVENT_SUBSCRIBE(NORMAL_LISTENER(idx), ename);
+
+#define SUBSCRIBE_ALL(idx)						\
+	SUBS_REPEAT(CONFIG_BENCH_SUBSCRIBER_CNT, SUBSCRIBE,		\
+		    BENCH_EVENT(idx))					\
+	EVENT_SUBSCRIBE_FINAL(bench_final, BENCH_EVENT(idx));
+
+BENCH_REPEAT(CONFIG_BENCH_EVENT_TYPE_CNT, SUBSCRIBE_ALL)
+
+
+void bench_listeners_prepare(struct bench_result *res, u32_t event_cnt,
+			     struct k_sem *sem)
+{
+	result = res;
+	expected_cnt = event_cnt;
+	done_sem = sem;
+}
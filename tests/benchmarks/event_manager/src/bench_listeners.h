@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _BENCH_LISTENERS_H_
+#define _BENCH_LISTENERS_H_
+
+#include <zephyr.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Benchmark result collected by the listeners. */
+struct bench_result {
+	/** Number of events received by the final subscriber. */
+	u32_t handled_cnt;
+
+	/** Number of latency samples. */
+	u32_t sample_cnt;
+
+	/** Submit-to-handle latency of every event (in cycles). */
+	u32_t latency[CONFIG_BENCH_EVENT_CNT];
+};
+
+/** Prepare the listeners for a benchmark run.
+ *
+ * @param res		Result to fill.
+ * @param event_cnt	Number of events after which the semaphore is given.
+ * @param sem		Semaphore given when all events were handled.
+ */
+void bench_listeners_prepare(struct bench_result *res, u32_t event_cnt,
+			     struct k_sem *sem);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BENCH_LISTENERS_H_ */
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <misc/printk.h>
+#include <event_manager.h>
+
+#include "bench_events.h"
+#include "bench_listeners.h"
+
+#define BURST_TIMEOUT K_SECONDS(1)
+
+
+static K_SEM_DEFINE(done_sem, 0, 1);
+
+static struct bench_result result;
+
+
+static u32_t cycles_to_us(u32_t cycles)
+{
+	return SYS_CLOCK_HW_CYCLES_TO_NS64(cycles) / NSEC_PER_USEC;
+}
+
+static void latency_sort(u32_t *latency, size_t cnt)
+{
+	/* Shell sort, no need for anything faster here. */
+	for (size_t gap = cnt / 2; gap > 0; gap /= 2) {
+		for (size_t i = gap; i < cnt; i++) {
+			u32_t val = latency[i];
+			size_t j = i;
+
+			while ((j >= gap) && (latency[j - gap] > val)) {
+				latency[j] = latency[j - gap];
+				j -= gap;
+			}
+			latency[j] = val;
+		}
+	}
+}
+
+static u32_t latency_percentile_us(unsigned int percentile)
+{
+	__ASSERT_NO_MSG(result.sample_cnt > 0);
+
+	size_t idx = (result.sample_cnt * percentile) / 100;
+
+	if (idx >= result.sample_cnt) {
+		idx = result.sample_cnt - 1;
+	}
+
+	return cycles_to_us(result.latency[idx]);
+}
+
+static size_t alloc_size_get(void)
+{
+	if (IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_ALLOC_POOL)) {
+		struct event_manager_pool_stats stats;
+
+		/* Event is placed in the smallest fitting block. */
+		for (size_t i = 0; !event_manager_pool_stats_get(i, &stats);
+		     i++) {
+			if (BENCH_EVENT_SIZE <= stats.block_size) {
+				return stats.block_size;
+			}
+		}
+
+		return 0;
+	}
+
+	/* Heap allocator stores the block descriptor in front of the event.
+	 * Rounding to the heap block size is not included.
+	 */
+	return BENCH_EVENT_SIZE + sizeof(struct k_mem_block_id);
+}
+
+static const char *delivery_class_name(void)
+{
+	static const char * const names[] = {
+		[EVENT_DELIVERY_DEFAULT] = "default",
+		[EVENT_DELIVERY_REALTIME] = "realtime",
+		[EVENT_DELIVERY_BULK] = "bulk",
+	};
+
+	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_DELIVERY_CLASSES)) {
+		/* All events are processed by the system work queue. */
+		return "off";
+	}
+
+	return names[BENCH_DELIVERY_CLASS];
+}
+
+static int bench_run(u32_t *cycles)
+{
+	size_t type_idx = 0;
+	u32_t start = k_cycle_get_32();
+
+	for (size_t sent = 0; sent < CONFIG_BENCH_EVENT_CNT;) {
+		size_t burst = MIN(CONFIG_BENCH_BURST_SIZE,
+				   CONFIG_BENCH_EVENT_CNT - sent);
+
+		bench_listeners_prepare(&result, sent + burst, &done_sem);
+
+		/* Queue the whole burst before the processing starts. */
+		k_sched_lock();
+
+		for (size_t i = 0; i < burst; i++) {
+			struct event_header *eh = bench_event_new(type_idx);
+
+			bench_data_get(eh)->timestamp = k_cycle_get_32();
+			_event_submit(eh);
+
+			type_idx = (type_idx + 1) % CONFIG_BENCH_EVENT_TYPE_CNT;
+		}
+
+		k_sched_unlock();
+
+		if (k_sem_take(&done_sem, BURST_TIMEOUT)) {
+			return -ETIMEDOUT;
+		}
+
+		sent += burst;
+	}
+
+	*cycles = k_cycle_get_32() - start;
+
+	return 0;
+}
+
+static void result_print(u32_t cycles)
+{
+	u64_t ns = MAX(SYS_CLOCK_HW_CYCLES_TO_NS64(cycles), 1);
+	u64_t events_per_s = (u64_t)CONFIG_BENCH_EVENT_CNT * NSEC_PER_SEC / ns;
+
+	latency_sort(result.latency, result.sample_cnt);
+
+	printk("event_types,subscribers,payload,profiler,queue,alloc,"
+	       "dispatch,delivery,events,events_per_s,lat_p50_us,lat_p90_us,"
+	       "lat_p99_us,lat_max_us,event_size,alloc_size\n");
+	printk("%u,%u,%u,%s,%s,%s,%s,%s,%u,%u,%u,%u,%u,%u,%zu,%zu\n",
+	       CONFIG_BENCH_EVENT_TYPE_CNT,
+	       CONFIG_BENCH_SUBSCRIBER_CNT,
+	       CONFIG_BENCH_PAYLOAD_SIZE,
+	       IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_PROFILER_ENABLED) ?
+			"on" : "off",
+	       IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_LOCKFREE_QUEUE) ?
+			"lockfree" : "spinlock",
+	       IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_ALLOC_POOL) ?
+			"pool" : "heap",
+	       IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_DISPATCH_TABLE) ?
+			"table" : "list",
+	       delivery_class_name(),
+	       CONFIG_BENCH_EVENT_CNT,
+	       (u32_t)events_per_s,
+	       latency_percentile_us(50),
+	       latency_percentile_us(90),
+	       latency_percentile_us(99),
+	       latency_percentile_us(100),
+	       BENCH_EVENT_SIZE,
+	       alloc_size_get());
+}
+
+void main(void)
+{
+	if (event_manager_init()) {
+		printk("Event Manager not initialized\n");
+		return;
+	}
+
+	u32_t cycles;
+	int err = bench_run(&cycles);
+
+	if (err) {
+		printk("Benchmark failed (err: %d)\n", err);
+		return;
+	}
+
+	result_print(cycles);
+}
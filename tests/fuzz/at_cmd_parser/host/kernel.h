@@ -0,0 +1,12 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef HOST_KERNEL_H_
+#define HOST_KERNEL_H_
+
+#include <zephyr.h>
+
+#endif /* HOST_KERNEL_H_ */
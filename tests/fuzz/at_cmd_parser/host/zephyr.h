@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+/* Minimal replacement of the Zephyr kernel API used by the AT command parser,
+ * for building the parser on the host.
+ */
+
+#ifndef HOST_ZEPHYR_H_
+#define HOST_ZEPHYR_H_
+
+#include <errno.h>
+#include <stdlib.h>
+#include <zephyr/types.h>
+
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#define ARG_UNUSED(x) (void)(x)
+#define ARRAY_SIZE(array) (sizeof(array) / sizeof((array)[0]))
+
+#define __ASSERT(test, fmt, ...) do { if (!(test)) { abort(); } } while (0)
+#define __ASSERT_NO_MSG(test) __ASSERT(test, "")
+
+static inline void *k_malloc(size_t size)
+{
+	return malloc(size);
+}
+
+static inline void *k_calloc(size_t nmemb, size_t size)
+{
+	return calloc(nmemb, size);
+}
+
+static inline void k_free(void *ptr)
+{
+	free(ptr);
+}
+
+#endif /* HOST_ZEPHYR_H_ */
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr.h>
+
+#include <at_cmd_parser.h>
+#include <at_params.h>
+
+#define PARAM_CNT 16
+#define ARENA_SIZE 128
+#define LINE_BUF_SIZE 256
+#define CHUNK_SIZE_MAX 32
+
+
+static void param_list_check(const struct at_param_list *list)
+{
+	for (size_t i = 0; i < list->param_count; i++) {
+		const struct at_param *param = &list->params[i];
+
+		switch (param->type) {
+		case AT_PARAM_TYPE_EMPTY:
+		case AT_PARAM_TYPE_NUM_SHORT:
+		case AT_PARAM_TYPE_NUM_INT:
+			break;
+
+		case AT_PARAM_TYPE_STRING: {
+			char str[LINE_BUF_SIZE];
+			size_t size;
+
+			/* Copying the whole value lets the sanitizer detect
+			 * reads out of bounds.
+			 */
+			__ASSERT_NO_MSG(!at_params_size_get(list, i, &size));
+			__ASSERT_NO_MSG(size == strlen(param->value.str_val));
+
+			if (size <= sizeof(str)) {
+				__ASSERT_NO_MSG(at_params_string_get(
+					list, i, str, sizeof(str)) == size);
+			}
+			break;
+		}
+
+		default:
+			__ASSERT_NO_MSG(false);
+			break;
+		}
+	}
+}
+
+static void params_parse(struct at_param_list *list, const u8_t *data,
+			 size_t size)
+{
+	/* Fuzz input is not null-terminated, so a terminated copy is used. */
+	char *str = malloc(size + 1);
+
+	__ASSERT_NO_MSG(str != NULL);
+
+	memcpy(str, data, size);
+	str[size] = '\0';
+
+	int err = at_parser_params_from_str(str, list);
+
+	if (!err) {
+		param_list_check(list);
+	}
+
+	free(str);
+}
+
+static void stream_handler(const char *prefix, struct at_param_list *list,
+			   void *user_data)
+{
+	__ASSERT_NO_MSG(strlen(prefix) > 0);
+	ARG_UNUSED(user_data);
+
+	param_list_check(list);
+}
+
+static void stream_parse(struct at_param_list *list, const u8_t *data,
+			 size_t size, size_t chunk_size)
+{
+	static const struct at_parser_prefix_handler handlers[] = {
+		{ "%CESQ", stream_handler },
+		{ "%XSIM", stream_handler },
+		{ "+CEREG", stream_handler },
+		{ "+CGDCONT", stream_handler },
+		{ "+CME ERROR", stream_handler },
+		{ "+CSQ", stream_handler },
+		{ "OK", stream_handler },
+	};
+	static char line_buf[LINE_BUF_SIZE];
+	struct at_parser_stream stream;
+
+	int err = at_parser_stream_init(&stream, list, handlers,
+					ARRAY_SIZE(handlers), line_buf,
+					sizeof(line_buf), NULL);
+
+	__ASSERT_NO_MSG(!err);
+
+	while (size > 0) {
+		size_t len = MIN(chunk_size, size);
+
+		(void)at_parser_stream_feed(&stream, (const char *)data, len);
+
+		data += len;
+		size -= len;
+	}
+}
+
+int LLVMFuzzerTestOneInput(const u8_t *data, size_t size)
+{
+	static struct at_param_list heap_list;
+	static struct at_param_list arena_list;
+
+	if (heap_list.params == NULL) {
+		__ASSERT_NO_MSG(!at_params_list_init(&heap_list, PARAM_CNT));
+		__ASSERT_NO_MSG(!at_params_list_arena_init(&arena_list,
+							   PARAM_CNT,
+							   ARENA_SIZE));
+	}
+
+	if (size == 0) {
+		return 0;
+	}
+
+	/* First byte selects size of the chunks passed to the stream
+	 * parser.
+	 */
+	size_t chunk_size = (data[0] % CHUNK_SIZE_MAX) + 1;
+
+	data++;
+	size--;
+
+	params_parse(&heap_list, data, size);
+	params_parse(&arena_list, data, size);
+	stream_parse(&arena_list, data, size, chunk_size);
+
+	return 0;
+}
+
+#ifdef FUZZ_REPLAY
+/* Runs the fuzzer entry point on the given files, without fuzzing. */
+int main(int argc, char **argv)
+{
+	for (int i = 1; i < argc; i++) {
+		FILE *f = fopen(argv[i], "rb");
+
+		if (f == NULL) {
+			fprintf(stderr, "Cannot open %s\n", argv[i]);
+			return 1;
+		}
+
+		static u8_t data[4096];
+		size_t size = fread(data, 1, sizeof(data), f);
+
+		fclose(f);
+
+		LLVMFuzzerTestOneInput(data, size);
+		printf("%s: %zu bytes\n", argv[i], size);
+	}
+
+	return 0;
+}
+#endif /* FUZZ_REPLAY */
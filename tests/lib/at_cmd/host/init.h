@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef HOST_INIT_H_
+#define HOST_INIT_H_
+
+struct device;
+
+/* Initialization function is called by the test. */
+#define SYS_INIT(init_fn, level, prio)			\
+	int host_sys_init_##init_fn(void)		\
+	{						\
+		return init_fn(NULL);			\
+	}
+
+#endif /* HOST_INIT_H_ */
@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef HOST_LOGGING_LOG_H_
+#define HOST_LOGGING_LOG_H_
+
+#include <stdio.h>
+
+#define LOG_MODULE_REGISTER(...)
+
+#define LOG_ERR(fmt, ...) printf("<err> " fmt "\n", ##__VA_ARGS__)
+#define LOG_WRN(fmt, ...) printf("<wrn> " fmt "\n", ##__VA_ARGS__)
+#define LOG_INF(fmt, ...) printf("<inf> " fmt "\n", ##__VA_ARGS__)
+#define LOG_DBG(fmt, ...) do { } while (0)
+
+/* Messages are printed immediately. */
+#define log_strdup(str) (str)
+
+#endif /* HOST_LOGGING_LOG_H_ */
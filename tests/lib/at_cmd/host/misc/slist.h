@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+/* Subset of the Zephyr single-linked list used by the AT command service. */
+
+#ifndef HOST_MISC_SLIST_H_
+#define HOST_MISC_SLIST_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct _snode {
+	struct _snode *next;
+};
+
+typedef struct _snode sys_snode_t;
+
+struct _slist {
+	sys_snode_t *head;
+	sys_snode_t *tail;
+};
+
+typedef struct _slist sys_slist_t;
+
+static inline void sys_slist_init(sys_slist_t *list)
+{
+	list->head = NULL;
+	list->tail = NULL;
+}
+
+static inline bool sys_slist_is_empty(sys_slist_t *list)
+{
+	return list->head == NULL;
+}
+
+static inline sys_snode_t *sys_slist_peek_head(sys_slist_t *list)
+{
+	return list->head;
+}
+
+static inline void sys_slist_append(sys_slist_t *list, sys_snode_t *node)
+{
+	node->next = NULL;
+
+	if (list->tail) {
+		list->tail->next = node;
+	} else {
+		list->head = node;
+	}
+	list->tail = node;
+}
+
+static inline sys_snode_t *sys_slist_get_not_empty(sys_slist_t *list)
+{
+	sys_snode_t *node = list->head;
+
+	list->head = node->next;
+	if (list->head == NULL) {
+		list->tail = NULL;
+	}
+
+	return node;
+}
+
+static inline sys_snode_t *sys_slist_get(sys_slist_t *list)
+{
+	return sys_slist_is_empty(list) ? NULL : sys_slist_get_not_empty(list);
+}
+
+static inline bool sys_slist_find_and_remove(sys_slist_t *list,
+					     sys_snode_t *node)
+{
+	sys_snode_t *prev = NULL;
+
+	for (sys_snode_t *it = list->head; it; prev = it, it = it->next) {
+		if (it != node) {
+			continue;
+		}
+
+		if (prev) {
+			prev->next = it->next;
+		} else {
+			list->head = it->next;
+		}
+		if (list->tail == it) {
+			list->tail = prev;
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+#define SYS_SLIST_CONTAINER(node, cn, field) \
+	((node) ? CONTAINER_OF(node, __typeof__(*(cn)), field) : NULL)
+
+#define SYS_SLIST_FOR_EACH_CONTAINER(list, cn, field)			\
+	for (cn = SYS_SLIST_CONTAINER((list)->head, cn, field); cn;	\
+	     cn = SYS_SLIST_CONTAINER((cn)->field.next, cn, field))
+
+#endif /* HOST_MISC_SLIST_H_ */
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+/* AT socket of the modem is replaced by one end of a host socket pair. */
+
+#ifndef HOST_NET_SOCKET_H_
+#define HOST_NET_SOCKET_H_
+
+#include <poll.h>
+#include <sys/socket.h>
+
+#define AF_LTE 102
+#define NPROTO_AT 513
+
+#define ZSOCK_POLLIN POLLIN
+
+int host_at_socket(int family, int type, int proto);
+
+#define socket(family, type, proto) host_at_socket(family, type, proto)
+
+#endif /* HOST_NET_SOCKET_H_ */
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+/* Minimal replacement of the Zephyr kernel API used by the AT command
+ * service, for running the service on the host. Kernel objects are
+ * implemented with POSIX threads, time is given in milliseconds.
+ */
+
+#ifndef HOST_ZEPHYR_H_
+#define HOST_ZEPHYR_H_
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <time.h>
+#include <zephyr/types.h>
+
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#define ARG_UNUSED(x) (void)(x)
+#define ARRAY_SIZE(array) (sizeof(array) / sizeof((array)[0]))
+#define CONTAINER_OF(ptr, type, field) \
+	((type *)(((char *)(ptr)) - offsetof(type, field)))
+
+#define __ASSERT(test, fmt, ...) do { if (!(test)) { abort(); } } while (0)
+#define __ASSERT_NO_MSG(test) __ASSERT(test, "")
+
+#define K_NO_WAIT 0
+#define K_FOREVER (-1)
+#define K_MSEC(ms) (ms)
+#define K_SECONDS(s) ((s) * 1000)
+#define K_PRIO_PREEMPT(x) (x)
+
+static inline void *k_malloc(size_t size)
+{
+	return malloc(size);
+}
+
+static inline void *k_calloc(size_t nmemb, size_t size)
+{
+	return calloc(nmemb, size);
+}
+
+static inline void k_free(void *ptr)
+{
+	free(ptr);
+}
+
+static inline s64_t k_uptime_get(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (s64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static inline void host_cond_init(pthread_cond_t *cond)
+{
+	pthread_condattr_t attr;
+
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(cond, &attr);
+	pthread_condattr_destroy(&attr);
+}
+
+/* Waits until the uptime given in milliseconds. Returns nonzero on
+ * timeout.
+ */
+static inline int host_cond_wait_until(pthread_cond_t *cond,
+				       pthread_mutex_t *mutex, s64_t uptime)
+{
+	struct timespec ts = {
+		.tv_sec = uptime / 1000,
+		.tv_nsec = (uptime % 1000) * 1000000,
+	};
+
+	return pthread_cond_timedwait(cond, mutex, &ts);
+}
+
+struct k_mutex {
+	pthread_mutex_t mutex;
+};
+
+static inline void k_mutex_init(struct k_mutex *mutex)
+{
+	pthread_mutexattr_t attr;
+
+	/* Kernel mutexes can be locked recursively by the owner. */
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&mutex->mutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+}
+
+static inline int k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
+{
+	ARG_UNUSED(timeout);
+
+	return pthread_mutex_lock(&mutex->mutex);
+}
+
+static inline void k_mutex_unlock(struct k_mutex *mutex)
+{
+	pthread_mutex_unlock(&mutex->mutex);
+}
+
+struct k_poll_signal {
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	unsigned int signaled;
+	int result;
+};
+
+#define K_POLL_TYPE_SIGNAL 1
+#define K_POLL_MODE_NOTIFY_ONLY 0
+
+struct k_poll_event {
+	struct k_poll_signal *signal;
+};
+
+#define K_POLL_EVENT_INITIALIZER(type, mode, obj) { .signal = (obj) }
+
+static inline void k_poll_signal_init(struct k_poll_signal *signal)
+{
+	pthread_mutex_init(&signal->mutex, NULL);
+	host_cond_init(&signal->cond);
+	signal->signaled = 0;
+	signal->result = 0;
+}
+
+static inline int k_poll_signal_raise(struct k_poll_signal *signal,
+				      int result)
+{
+	pthread_mutex_lock(&signal->mutex);
+	signal->signaled = 1;
+	signal->result = result;
+	pthread_cond_broadcast(&signal->cond);
+	pthread_mutex_unlock(&signal->mutex);
+
+	return 0;
+}
+
+/* Only a single signal event is supported. */
+static inline int k_poll(struct k_poll_event *events, int num_events,
+			 s32_t timeout)
+{
+	struct k_poll_signal *signal = events[0].signal;
+	s64_t end = k_uptime_get() + timeout;
+	int err = 0;
+
+	__ASSERT_NO_MSG(num_events == 1);
+
+	pthread_mutex_lock(&signal->mutex);
+	while (!signal->signaled && !err) {
+		if (timeout == K_FOREVER) {
+			pthread_cond_wait(&signal->cond, &signal->mutex);
+		} else {
+			err = host_cond_wait_until(&signal->cond,
+						   &signal->mutex, end);
+		}
+	}
+	err = signal->signaled ? 0 : -EAGAIN;
+	pthread_mutex_unlock(&signal->mutex);
+
+	return err;
+}
+
+typedef void (*k_thread_entry_t)(void *p1, void *p2, void *p3);
+
+struct k_thread {
+	pthread_t thread;
+	k_thread_entry_t entry;
+};
+
+typedef struct k_thread *k_tid_t;
+
+#define K_THREAD_STACK_DEFINE(sym, size) char sym[size]
+#define K_THREAD_STACK_SIZEOF(sym) sizeof(sym)
+
+static inline void *host_thread_fn(void *arg)
+{
+	struct k_thread *thread = arg;
+
+	thread->entry(NULL, NULL, NULL);
+
+	return NULL;
+}
+
+static inline k_tid_t k_thread_create(struct k_thread *thread, char *stack,
+				      size_t stack_size,
+				      k_thread_entry_t entry,
+				      void *p1, void *p2, void *p3,
+				      int prio, u32_t options, s32_t delay)
+{
+	thread->entry = entry;
+	pthread_create(&thread->thread, NULL, host_thread_fn, thread);
+	pthread_detach(thread->thread);
+
+	return thread;
+}
+
+struct k_work;
+
+typedef void (*k_work_handler_t)(struct k_work *work);
+
+struct k_work {
+	k_work_handler_t handler;
+};
+
+/* Every delayed work has its own thread that runs the handler. */
+struct k_delayed_work {
+	struct k_work work;
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	/* Uptime at which the work runs, negative if not submitted. */
+	s64_t deadline;
+};
+
+static inline void *host_delayed_work_fn(void *arg)
+{
+	struct k_delayed_work *work = arg;
+
+	pthread_mutex_lock(&work->mutex);
+
+	while (true) {
+		if (work->deadline < 0) {
+			pthread_cond_wait(&work->cond, &work->mutex);
+		} else if (host_cond_wait_until(&work->cond, &work->mutex,
+						work->deadline) &&
+			   (work->deadline >= 0) &&
+			   (k_uptime_get() >= work->deadline)) {
+			work->deadline = -1;
+			pthread_mutex_unlock(&work->mutex);
+			work->work.handler(&work->work);
+			pthread_mutex_lock(&work->mutex);
+		}
+	}
+
+	return NULL;
+}
+
+static inline void k_delayed_work_init(struct k_delayed_work *work,
+				       k_work_handler_t handler)
+{
+	work->work.handler = handler;
+	work->deadline = -1;
+	pthread_mutex_init(&work->mutex, NULL);
+	host_cond_init(&work->cond);
+	pthread_create(&work->thread, NULL, host_delayed_work_fn, work);
+	pthread_detach(work->thread);
+}
+
+static inline int k_delayed_work_submit(struct k_delayed_work *work,
+					s32_t delay)
+{
+	pthread_mutex_lock(&work->mutex);
+	work->deadline = k_uptime_get() + delay;
+	pthread_cond_signal(&work->cond);
+	pthread_mutex_unlock(&work->mutex);
+
+	return 0;
+}
+
+static inline int k_delayed_work_cancel(struct k_delayed_work *work)
+{
+	pthread_mutex_lock(&work->mutex);
+	work->deadline = -1;
+	pthread_cond_signal(&work->cond);
+	pthread_mutex_unlock(&work->mutex);
+
+	return 0;
+}
+
+#endif /* HOST_ZEPHYR_H_ */
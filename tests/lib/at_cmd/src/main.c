@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+/* Tests of the AT command service against a scripted modem. The modem end
+ * of the AT socket is read and written directly by the tests.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zephyr.h>
+#include <net/socket.h>
+#include <at_cmd.h>
+
+#define CHECK(cond)							\
+	do {								\
+		if (!(cond)) {						\
+			printf("%s:%d: check failed: %s\n",		\
+			       __FILE__, __LINE__, #cond);		\
+			exit(EXIT_FAILURE);				\
+		}							\
+	} while (0)
+
+/* Longer than the response timeout of the test build. */
+#define TIMEOUT_WAIT K_SECONDS(CONFIG_AT_CMD_RESPONSE_TIMEOUT + 2)
+/* Time in which a command would have been sent. */
+#define SEND_WAIT K_MSEC(200)
+
+struct test_request {
+	struct at_cmd_request req;
+	struct k_poll_signal signal;
+	char resp[32];
+};
+
+static int modem_fd;
+
+int host_sys_init_at_cmd_init(void);
+
+int host_at_socket(int family, int type, int proto)
+{
+	int fds[2];
+
+	CHECK((family == AF_LTE) && (proto == NPROTO_AT));
+	ARG_UNUSED(type);
+
+	/* Message boundaries are kept, as on the AT socket. */
+	CHECK(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) == 0);
+	modem_fd = fds[1];
+
+	return fds[0];
+}
+
+static void request_submit(struct test_request *t, const char *cmd)
+{
+	memset(t, 0, sizeof(*t));
+	k_poll_signal_init(&t->signal);
+	t->req.cmd = cmd;
+	t->req.resp = t->resp;
+	t->req.resp_size = sizeof(t->resp);
+	t->req.signal = &t->signal;
+
+	CHECK(at_cmd_submit(&t->req) == 0);
+}
+
+static int request_wait(struct test_request *t, s32_t timeout)
+{
+	struct k_poll_event event = K_POLL_EVENT_INITIALIZER(
+		K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &t->signal);
+
+	return k_poll(&event, 1, timeout);
+}
+
+/* Returns true if the command was received by the modem in time. */
+static bool modem_cmd_get(const char *cmd, s32_t timeout)
+{
+	struct pollfd fds = {
+		.fd = modem_fd,
+		.events = POLLIN,
+	};
+	char buf[64];
+
+	if (poll(&fds, 1, timeout) <= 0) {
+		return false;
+	}
+
+	ssize_t len = recv(modem_fd, buf, sizeof(buf) - 1, 0);
+
+	CHECK(len > 0);
+	buf[len] = '\0';
+	CHECK(!strcmp(buf, cmd));
+
+	return true;
+}
+
+static void modem_send(const char *data, size_t len)
+{
+	CHECK(send(modem_fd, data, len, 0) == len);
+}
+
+static void modem_send_str(const char *str)
+{
+	modem_send(str, strlen(str));
+}
+
+static void test_response(void)
+{
+	struct test_request t;
+
+	request_submit(&t, "AT+CFUN?");
+	CHECK(modem_cmd_get("AT+CFUN?", SEND_WAIT));
+	modem_send_str("+CFUN: 1\r\nOK\r\n");
+
+	CHECK(request_wait(&t, SEND_WAIT) == 0);
+	CHECK(t.req.result == 0);
+	CHECK(t.req.state == AT_CMD_OK);
+	CHECK(!strcmp(t.resp, "+CFUN: 1\r\nOK\r\n"));
+}
+
+static void test_timeout_late_response_discarded(void)
+{
+	struct test_request failed;
+	struct test_request next;
+
+	request_submit(&failed, "AT+COPS=?");
+	CHECK(modem_cmd_get("AT+COPS=?", SEND_WAIT));
+	CHECK(request_wait(&failed, TIMEOUT_WAIT) == 0);
+	CHECK(failed.req.result == -ETIMEDOUT);
+	CHECK(failed.req.state == AT_CMD_ERROR);
+
+	/* Next command waits for the response of the failed one. */
+	request_submit(&next, "AT+CGSN");
+	CHECK(!modem_cmd_get("AT+CGSN", SEND_WAIT));
+
+	modem_send_str("ERROR\r\n");
+	CHECK(modem_cmd_get("AT+CGSN", SEND_WAIT));
+	CHECK(request_wait(&next, SEND_WAIT) == -EAGAIN);
+
+	modem_send_str("123456789012345\r\nOK\r\n");
+	CHECK(request_wait(&next, SEND_WAIT) == 0);
+	CHECK(next.req.result == 0);
+	CHECK(!strcmp(next.resp, "123456789012345\r\nOK\r\n"));
+}
+
+static void test_truncated_response_discarded(void)
+{
+	struct test_request failed;
+	struct test_request next;
+	char data[CONFIG_AT_CMD_RECV_BUF_SIZE];
+
+	request_submit(&failed, "AT%XMONITOR");
+	CHECK(modem_cmd_get("AT%XMONITOR", SEND_WAIT));
+
+	/* Response does not fit in the buffer of the service. */
+	memset(data, 'x', sizeof(data));
+	modem_send(data, sizeof(data));
+	CHECK(request_wait(&failed, SEND_WAIT) == 0);
+	CHECK(failed.req.result == -ENOBUFS);
+
+	request_submit(&next, "AT+CFUN?");
+	CHECK(!modem_cmd_get("AT+CFUN?", SEND_WAIT));
+
+	/* Rest of the response is not taken as a notification or as the
+	 * response of the next command.
+	 */
+	modem_send(data, sizeof(data));
+	CHECK(!modem_cmd_get("AT+CFUN?", SEND_WAIT));
+	modem_send_str("xxxx\r\nOK\r\n");
+	CHECK(modem_cmd_get("AT+CFUN?", SEND_WAIT));
+	CHECK(request_wait(&next, SEND_WAIT) == -EAGAIN);
+
+	modem_send_str("+CFUN: 4\r\nOK\r\n");
+	CHECK(request_wait(&next, SEND_WAIT) == 0);
+	CHECK(next.req.result == 0);
+	CHECK(!strcmp(next.resp, "+CFUN: 4\r\nOK\r\n"));
+}
+
+static void test_timeout_without_response(void)
+{
+	struct test_request failed;
+	struct test_request next;
+
+	request_submit(&failed, "AT+CEREG?");
+	CHECK(modem_cmd_get("AT+CEREG?", SEND_WAIT));
+	CHECK(request_wait(&failed, TIMEOUT_WAIT) == 0);
+	CHECK(failed.req.result == -ETIMEDOUT);
+
+	/* Queue does not stall if the modem never ends the command. */
+	request_submit(&next, "AT+CGSN");
+	CHECK(modem_cmd_get("AT+CGSN", TIMEOUT_WAIT));
+	modem_send_str("OK\r\n");
+	CHECK(request_wait(&next, SEND_WAIT) == 0);
+	CHECK(next.req.result == 0);
+}
+
+int main(void)
+{
+	CHECK(host_sys_init_at_cmd_init() == 0);
+
+	test_response();
+	test_timeout_late_response_discarded();
+	test_truncated_response_discarded();
+	test_timeout_without_response();
+
+	printf("PASS\n");
+
+	return 0;
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <at_cmd_parser.h>
+
+#define PARAMS_MAX 10
+
+static struct at_param_list list;
+static struct at_parser_stream stream;
+static char line_buf[128];
+
+static u32_t cereg_cnt;
+static u16_t cereg_stat;
+
+static void cereg_handler(const char *prefix, struct at_param_list *params,
+			  void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	zassert_equal(strcmp(prefix, "+CEREG"), 0, "Wrong prefix");
+	zassert_equal(at_params_short_get(params, 0, &cereg_stat), 0,
+		      "Status not parsed");
+	cereg_cnt++;
+}
+
+static const struct at_parser_prefix_handler handlers[] = {
+	{ "+CEREG", cereg_handler },
+};
+
+static void stream_setup(void)
+{
+	cereg_cnt = 0;
+	cereg_stat = 0;
+
+	zassert_equal(at_params_list_init(&list, PARAMS_MAX), 0,
+		      "List not initialized");
+	zassert_equal(at_parser_stream_init(&stream, &list, handlers,
+					    ARRAY_SIZE(handlers), line_buf,
+					    sizeof(line_buf), NULL), 0,
+		      "Stream not initialized");
+}
+
+static void stream_teardown(void)
+{
+	at_params_list_free(&list);
+}
+
+static void feed(const char *data)
+{
+	zassert_equal(at_parser_stream_feed(&stream, data, strlen(data)), 0,
+		      "Data not parsed");
+}
+
+static void test_stream_urc(void)
+{
+	feed("+CEREG: 1,\"0B1A\",\"0012BEEF\",7\r\n");
+
+	zassert_equal(cereg_cnt, 1, "URC not dispatched");
+	zassert_equal(cereg_stat, 1, "Wrong status");
+}
+
+static void test_stream_split_urc(void)
+{
+	feed("+CER");
+	feed("EG: 5,\"0B1A\"");
+	zassert_equal(cereg_cnt, 0, "Incomplete line dispatched");
+
+	feed(",\"0012BEEF\",7\r\n");
+	zassert_equal(cereg_cnt, 1, "URC not dispatched");
+	zassert_equal(cereg_stat, 5, "Wrong status");
+}
+
+static void test_stream_echo_skipped(void)
+{
+	/* Echo would be read as "registered, roaming" if dispatched. */
+	feed("AT+CEREG=5\r\n");
+	feed("at+cereg=5;+CEREG=5\r\n");
+	feed("At+CEREG?\r\nOK\r\n");
+	zassert_equal(cereg_cnt, 0, "Echo dispatched");
+
+	feed("AT+CEREG=5\r\n+CEREG: 2\r\n");
+	zassert_equal(cereg_cnt, 1, "URC not dispatched");
+	zassert_equal(cereg_stat, 2, "Status taken from echo");
+}
+
+static void params_setup(void)
+{
+	zassert_equal(at_params_list_init(&list, PARAMS_MAX), 0,
+		      "List not initialized");
+}
+
+static void params_teardown(void)
+{
+	at_params_list_free(&list);
+}
+
+static void parse(const char *str)
+{
+	strcpy(line_buf, str);
+	zassert_equal(at_parser_params_from_str(line_buf, &list), 0,
+		      "Parameters not parsed");
+}
+
+static u32_t int_get(size_t index)
+{
+	u32_t val;
+
+	zassert_equal(at_params_int_get(&list, index, &val), 0,
+		      "Not an integer parameter");
+	return val;
+}
+
+static u16_t short_get(size_t index)
+{
+	u16_t val;
+
+	zassert_equal(at_params_short_get(&list, index, &val), 0,
+		      "Not a short parameter");
+	return val;
+}
+
+static void string_check(size_t index, const char *expected)
+{
+	char buf[32];
+	int len = at_params_string_get(&list, index, buf, sizeof(buf));
+
+	zassert_equal(len, strlen(expected), "Wrong string length");
+	zassert_equal(memcmp(buf, expected, len), 0, "Wrong string");
+}
+
+static void test_params_hex(void)
+{
+	parse("0x1F,0XfFfF,0x10000,0x");
+
+	zassert_equal(short_get(0), 0x1F, "Wrong value");
+	zassert_equal(short_get(1), 0xFFFF, "Wrong value");
+	zassert_equal(int_get(2), 0x10000, "Wrong value");
+	string_check(3, "0x");
+}
+
+static void test_params_limits(void)
+{
+	parse("-2147483648,4294967295,0xFFFFFFFF,-1");
+
+	zassert_equal(int_get(0), (u32_t)INT32_MIN, "Wrong value");
+	zassert_equal(int_get(1), UINT32_MAX, "Wrong value");
+	zassert_equal(int_get(2), UINT32_MAX, "Wrong value");
+	zassert_equal(int_get(3), (u32_t)-1, "Wrong value");
+}
+
+static void test_params_overflow(void)
+{
+	/* Values that do not fit into 32 bits are kept as strings. */
+	parse("4294967296,-2147483649,0x100000000,99999999999");
+
+	string_check(0, "4294967296");
+	string_check(1, "-2147483649");
+	string_check(2, "0x100000000");
+	string_check(3, "99999999999");
+}
+
+static void test_params_unquoted_string(void)
+{
+	parse("abc ,12ab,-x;15");
+
+	string_check(0, "abc");
+	string_check(1, "12ab");
+	string_check(2, "-x");
+	zassert_equal(at_params_valid_count_get(&list), 3,
+		      "Parameters of the next command parsed");
+}
+
+static void test_params_quoted_string(void)
+{
+	parse("\"a,b;c\" ,\"\"");
+
+	string_check(0, "a,b;c");
+	string_check(1, "");
+}
+
+static void test_params_unterminated_quote(void)
+{
+	/* Closing quote on the next line is not taken. */
+	strcpy(line_buf, "\"0B1A\r\nOK\r\n\",1");
+	zassert_equal(at_parser_params_from_str(line_buf, &list), -EINVAL,
+		      "Unterminated string accepted");
+
+	strcpy(line_buf, "1,\"0B1A");
+	zassert_equal(at_parser_params_from_str(line_buf, &list), -EINVAL,
+		      "Unterminated string accepted");
+}
+
+static void arena_setup(void)
+{
+	zassert_equal(at_params_list_arena_init(&list, PARAMS_MAX, 8), 0,
+		      "List not initialized");
+}
+
+static void test_arena_exhausted(void)
+{
+	/* Every string value takes its length plus one byte. */
+	zassert_equal(at_params_string_put(&list, 0, "abc", 3), 0,
+		      "String not stored");
+	zassert_equal(at_params_string_put(&list, 1, "defg", 4), -ENOMEM,
+		      "Arena overrun");
+	zassert_equal(at_params_string_put(&list, 1, "def", 3), 0,
+		      "String not stored");
+	zassert_equal(at_params_string_put(&list, 2, "", 0), -ENOMEM,
+		      "Arena overrun");
+
+	string_check(0, "abc");
+	string_check(1, "def");
+}
+
+static void test_arena_list_clear(void)
+{
+	zassert_equal(at_params_string_put(&list, 0, "abcdefg", 7), 0,
+		      "String not stored");
+
+	at_params_list_clear(&list);
+	zassert_equal(list.arena->used, 0, "Arena not released");
+
+	zassert_equal(at_params_string_put(&list, 0, "hijklmn", 7), 0,
+		      "String not stored");
+	string_check(0, "hijklmn");
+}
+
+static void test_arena_string_replaced(void)
+{
+	zassert_equal(at_params_string_put(&list, 0, "abc", 3), 0,
+		      "String not stored");
+	zassert_equal(at_params_string_put(&list, 0, "de", 2), 0,
+		      "String not replaced");
+	string_check(0, "de");
+
+	/* Memory of the replaced value is released with the list only. */
+	zassert_equal(list.arena->used, 7, "Wrong arena usage");
+	zassert_equal(at_params_clear(&list, 0), 0, "String not cleared");
+	zassert_equal(list.arena->used, 7, "Wrong arena usage");
+
+	parse("\"xyz\"");
+	string_check(0, "xyz");
+	zassert_equal(list.arena->used, 4, "Arena not released");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(at_cmd_parser_tests,
+			 ztest_unit_test_setup_teardown(test_params_hex,
+				params_setup, params_teardown),
+			 ztest_unit_test_setup_teardown(test_params_limits,
+				params_setup, params_teardown),
+			 ztest_unit_test_setup_teardown(test_params_overflow,
+				params_setup, params_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_params_unquoted_string,
+				params_setup, params_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_params_quoted_string,
+				params_setup, params_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_params_unterminated_quote,
+				params_setup, params_teardown),
+			 ztest_unit_test_setup_teardown(test_arena_exhausted,
+				arena_setup, params_teardown),
+			 ztest_unit_test_setup_teardown(test_arena_list_clear,
+				arena_setup, params_teardown),
+			 ztest_unit_test_setup_teardown(
+				test_arena_string_replaced,
+				arena_setup, params_teardown),
+			 ztest_unit_test_setup_teardown(test_stream_urc,
+				stream_setup, stream_teardown),
+			 ztest_unit_test_setup_teardown(test_stream_split_urc,
+				stream_setup, stream_teardown),
+			 ztest_unit_test_setup_teardown(test_stream_echo_skipped,
+				stream_setup, stream_teardown)
+			 );
+
+	ztest_run_test_suite(at_cmd_parser_tests);
+}
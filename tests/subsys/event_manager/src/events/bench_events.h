@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _BENCH_EVENTS_H_
+#define _BENCH_EVENTS_H_
+
+/**
+ * @brief Dispatch Benchmark Events
+ * @defgroup bench_events Dispatch Benchmark Events
+ *
+ * Events with 1, 8 and 32 subscribers used to measure dispatch time.
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct bench1_event {
+	struct event_header header;
+};
+
+EVENT_TYPE_DECLARE(bench1_event);
+
+struct bench8_event {
+	struct event_header header;
+};
+
+EVENT_TYPE_DECLARE(bench8_event);
+
+struct bench32_event {
+	struct event_header header;
+};
+
+EVENT_TYPE_DECLARE(bench32_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _BENCH_EVENTS_H_ */
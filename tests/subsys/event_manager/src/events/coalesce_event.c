@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include "coalesce_event.h"
+
+
+static void merge_coalesce_event(struct event_header *queued,
+				 const struct event_header *eh)
+{
+	struct coalesce_event *dst = cast_coalesce_event(queued);
+	const struct coalesce_event *src = cast_coalesce_event(eh);
+
+	dst->dx += src->dx;
+	dst->dy += src->dy;
+}
+
+EVENT_TYPE_DEFINE(coalesce_event,
+		  false,
+		  NULL,
+		  NULL,
+		  EVENT_COALESCE(merge_coalesce_event));
@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include "delivery_events.h"
+
+
+EVENT_TYPE_DEFINE(realtime_event,
+		  false,
+		  NULL,
+		  NULL,
+		  EVENT_DELIVERY_CLASS(EVENT_DELIVERY_REALTIME));
+
+EVENT_TYPE_DEFINE(bulk_event,
+		  true,
+		  NULL,
+		  NULL,
+		  EVENT_DELIVERY_CLASS(EVENT_DELIVERY_BULK));
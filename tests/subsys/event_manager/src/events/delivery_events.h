@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _DELIVERY_EVENTS_H_
+#define _DELIVERY_EVENTS_H_
+
+/**
+ * @brief Realtime and Bulk Events
+ * @defgroup delivery_events Realtime and Bulk Events
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct realtime_event {
+	struct event_header header;
+
+	u32_t val;
+};
+
+EVENT_TYPE_DECLARE(realtime_event);
+
+struct bulk_event {
+	struct event_header header;
+};
+
+EVENT_TYPE_DECLARE(bulk_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _DELIVERY_EVENTS_H_ */
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include "dyndata_event.h"
+
+
+EVENT_TYPE_DEFINE(dyndata_event,
+		  false,
+		  NULL,
+		  NULL);
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _DYNDATA_EVENT_H_
+#define _DYNDATA_EVENT_H_
+
+/**
+ * @brief Dyndata Event
+ * @defgroup dyndata_event Dyndata Event
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct dyndata_event {
+	struct event_header header;
+
+	u8_t val;
+	struct event_dyndata dyndata;
+};
+
+EVENT_TYPE_DYNDATA_DECLARE(dyndata_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _DYNDATA_EVENT_H_ */
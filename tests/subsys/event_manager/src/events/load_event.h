@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _LOAD_EVENT_H_
+#define _LOAD_EVENT_H_
+
+/**
+ * @brief Load Event
+ * @defgroup load_event Load Event
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct load_event {
+	struct event_header header;
+
+	u32_t val;
+};
+
+EVENT_TYPE_DECLARE(load_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _LOAD_EVENT_H_ */
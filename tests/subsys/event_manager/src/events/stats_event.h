@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _STATS_EVENT_H_
+#define _STATS_EVENT_H_
+
+/**
+ * @brief Stats Event
+ * @defgroup stats_event Stats Event
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct stats_event {
+	struct event_header header;
+
+	u32_t val;
+};
+
+EVENT_TYPE_DECLARE(stats_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _STATS_EVENT_H_ */
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#ifndef _STRESS_EVENT_H_
+#define _STRESS_EVENT_H_
+
+/**
+ * @brief Stress Event
+ * @defgroup stress_event Stress Event
+ * @{
+ */
+
+#include "event_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct stress_event {
+	struct event_header header;
+
+	u8_t source;
+	u32_t seq;
+};
+
+EVENT_TYPE_DECLARE(stress_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _STRESS_EVENT_H_ */
@@ -27,6 +27,14 @@ enum test_id {
 	TEST_SUBSCRIBER_ORDER,
 	TEST_OOM_RESET,
 	TEST_MULTICONTEXT,
+	TEST_SUSTAINED_LOAD,
+	TEST_DELIVERY_CLASS,
+	TEST_DISPATCH_BENCH,
+	TEST_BATCH,
+	TEST_COALESCE,
+	TEST_STATS,
+	TEST_DYNDATA,
+	TEST_STRESS,
 
 	TEST_CNT
 };
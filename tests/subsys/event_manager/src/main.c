@@ -59,6 +59,55 @@ static void test_multicontext(void)
 	test_start(TEST_MULTICONTEXT);
 }
 
+static void test_sustained_load(void)
+{
+	test_start(TEST_SUSTAINED_LOAD);
+}
+
+static void test_delivery_class(void)
+{
+	test_start(TEST_DELIVERY_CLASS);
+}
+
+static void test_dispatch_bench(void)
+{
+	test_start(TEST_DISPATCH_BENCH);
+}
+
+static void test_batch(void)
+{
+	test_start(TEST_BATCH);
+}
+
+/* Coalesced events cannot be defined with the lock-free queue, so the test
+ * is not registered in that configuration.
+ */
+#if CONFIG_DESKTOP_EVENT_MANAGER_LOCKFREE_QUEUE
+#define TEST_COALESCE_CASE
+#else
+static void test_coalesce(void)
+{
+	test_start(TEST_COALESCE);
+}
+
+#define TEST_COALESCE_CASE ztest_unit_test(test_coalesce),
+#endif
+
+static void test_stats(void)
+{
+	test_start(TEST_STATS);
+}
+
+static void test_dyndata(void)
+{
+	test_start(TEST_DYNDATA);
+}
+
+static void test_stress(void)
+{
+	test_start(TEST_STRESS);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(event_manager_tests,
@@ -68,7 +117,15 @@ void test_main(void)
 			 ztest_unit_test(test_event_order),
 			 ztest_unit_test(test_subs_order),
 			 ztest_unit_test(test_oom_reset),
-			 ztest_unit_test(test_multicontext)
+			 ztest_unit_test(test_multicontext),
+			 ztest_unit_test(test_sustained_load),
+			 ztest_unit_test(test_delivery_class),
+			 ztest_unit_test(test_dispatch_bench),
+			 ztest_unit_test(test_batch),
+			 TEST_COALESCE_CASE
+			 ztest_unit_test(test_stats),
+			 ztest_unit_test(test_dyndata),
+			 ztest_unit_test(test_stress)
 			 );
 
 	ztest_run_test_suite(event_manager_tests);
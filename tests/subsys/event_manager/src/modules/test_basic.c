@@ -59,6 +59,25 @@ static bool event_handler(const struct event_header *eh)
 			break;
 		}
 
+		case TEST_BATCH:
+		{
+			sys_dlist_t batch;
+
+			sys_dlist_init(&batch);
+
+			for (size_t i = 0; i < TEST_BATCH_EVENT_CNT; i++) {
+				struct order_event *event = new_order_event();
+
+				event->val = i;
+				EVENT_BATCH_ADD(&batch, event);
+			}
+
+			event_submit_batch(&batch);
+			zassert_true(sys_dlist_is_empty(&batch),
+				     "Batch not emptied");
+			break;
+		}
+
 		case TEST_SUBSCRIBER_ORDER:
 		{
 			struct order_event *event = new_order_event();
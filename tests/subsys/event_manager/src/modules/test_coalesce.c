@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <coalesce_event.h>
+
+#include "test_config.h"
+
+#define MODULE test_coalesce
+
+#define EXPECTED_EVENT_CNT 1
+
+
+static enum test_id cur_test_id;
+static u32_t received_cnt;
+static s32_t dx_sum;
+static s32_t dy_sum;
+
+
+static void submit_events(void)
+{
+	sys_dlist_t batch;
+
+	/* Events are processed after this handler returns, so all of them
+	 * should be merged into the first one.
+	 */
+	for (size_t i = 0; i < TEST_COALESCE_EVENT_CNT; i++) {
+		struct coalesce_event *event = new_coalesce_event();
+
+		event->dx = 1;
+		event->dy = -1;
+		EVENT_SUBMIT(event);
+	}
+
+	sys_dlist_init(&batch);
+
+	for (size_t i = 0; i < TEST_COALESCE_EVENT_CNT; i++) {
+		struct coalesce_event *event = new_coalesce_event();
+
+		event->dx = 1;
+		event->dy = -1;
+		EVENT_BATCH_ADD(&batch, event);
+	}
+
+	event_submit_batch(&batch);
+
+	struct test_end_event *te = new_test_end_event();
+
+	te->test_id = cur_test_id;
+	EVENT_SUBMIT(te);
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		switch (st->test_id) {
+		case TEST_COALESCE:
+		{
+			cur_test_id = st->test_id;
+			received_cnt = 0;
+			dx_sum = 0;
+			dy_sum = 0;
+			submit_events();
+			break;
+		}
+
+		default:
+			/* Ignore other test cases, check if proper test_id. */
+			zassert_true(st->test_id < TEST_CNT,
+				     "test_id out of range");
+			break;
+		}
+
+		return false;
+	}
+
+	if (is_coalesce_event(eh)) {
+		struct coalesce_event *event = cast_coalesce_event(eh);
+
+		received_cnt++;
+		dx_sum += event->dx;
+		dy_sum += event->dy;
+
+		return false;
+	}
+
+	if (is_test_end_event(eh)) {
+		if (cur_test_id == TEST_COALESCE) {
+			zassert_equal(received_cnt, EXPECTED_EVENT_CNT,
+				      "Wrong number of events");
+			zassert_equal(dx_sum, 2 * TEST_COALESCE_EVENT_CNT,
+				      "Wrong merged value");
+			zassert_equal(dy_sum, -2 * TEST_COALESCE_EVENT_CNT,
+				      "Wrong merged value");
+		}
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE(MODULE, coalesce_event);
+EVENT_SUBSCRIBE_EARLY(MODULE, test_end_event);
@@ -13,3 +13,41 @@
 
 /* TEST_EVENT_ORDER */
 #define TEST_EVENT_ORDER_CNT 20
+
+
+/* TEST_SUSTAINED_LOAD */
+#define TEST_LOAD_BURST_CNT 8
+#define TEST_LOAD_ROUND_CNT 100
+
+
+/* TEST_DELIVERY_CLASS */
+#define TEST_REALTIME_EVENT_CNT 5
+#define TEST_REALTIME_TIMEOUT K_MSEC(100)
+
+
+/* TEST_DISPATCH_BENCH */
+#define TEST_DISPATCH_EVENT_CNT 16
+
+
+/* TEST_BATCH */
+#define TEST_BATCH_EVENT_CNT 10
+
+
+/* TEST_COALESCE */
+#define TEST_COALESCE_EVENT_CNT 10
+
+
+/* TEST_STATS */
+#define TEST_STATS_EVENT_CNT 10
+
+
+/* TEST_DYNDATA */
+#define TEST_DYNDATA_SIZE 20
+#define TEST_DYNDATA_VAL 0x5a
+
+
+/* TEST_STRESS */
+#define TEST_STRESS_THREAD_CNT 2
+#define TEST_STRESS_THREAD_EVENT_CNT 2000
+#define TEST_STRESS_ISR_EVENT_CNT 200
+#define TEST_STRESS_ISR_PERIOD K_MSEC(1)
@@ -66,6 +66,20 @@ static bool event_handler(const struct event_header *eh)
 				te->test_id = TEST_EVENT_ORDER;
 				EVENT_SUBMIT(te);
 			}
+		} else if (cur_test_id == TEST_BATCH) {
+			static int i;
+			struct order_event *event = cast_order_event(eh);
+
+			zassert_equal(event->val, i, "Incorrent event order");
+			i++;
+
+			if (i == TEST_BATCH_EVENT_CNT) {
+				struct test_end_event *te =
+					new_test_end_event();
+
+				te->test_id = TEST_BATCH;
+				EVENT_SUBMIT(te);
+			}
 		}
 
 		return false;
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <delivery_events.h>
+
+#include "test_config.h"
+
+#define MODULE test_delivery
+
+
+static K_SEM_DEFINE(realtime_sem, 0, 1);
+
+static enum test_id cur_test_id;
+static u32_t realtime_cnt;
+
+
+static void handle_bulk_event(void)
+{
+	realtime_cnt = 0;
+	k_sem_reset(&realtime_sem);
+
+	for (size_t i = 0; i < TEST_REALTIME_EVENT_CNT; i++) {
+		struct realtime_event *event = new_realtime_event();
+
+		event->val = i;
+		EVENT_SUBMIT(event);
+	}
+
+	/* Simulate slow listener. Realtime events should be processed
+	 * in the meantime only if delivery classes use separate
+	 * work queues.
+	 */
+	bool realtime_processed =
+		(k_sem_take(&realtime_sem, TEST_REALTIME_TIMEOUT) == 0);
+
+	zassert_equal(realtime_processed,
+		      IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_DELIVERY_CLASSES),
+		      "Realtime events delayed by bulk event");
+
+	struct test_end_event *te = new_test_end_event();
+
+	te->test_id = cur_test_id;
+	EVENT_SUBMIT(te);
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		switch (st->test_id) {
+		case TEST_DELIVERY_CLASS:
+		{
+			cur_test_id = st->test_id;
+
+			struct bulk_event *event = new_bulk_event();
+
+			EVENT_SUBMIT(event);
+			break;
+		}
+
+		default:
+			/* Ignore other test cases, check if proper test_id. */
+			zassert_true(st->test_id < TEST_CNT,
+				     "test_id out of range");
+			break;
+		}
+
+		return false;
+	}
+
+	if (is_bulk_event(eh)) {
+		handle_bulk_event();
+
+		return false;
+	}
+
+	if (is_realtime_event(eh)) {
+		struct realtime_event *event = cast_realtime_event(eh);
+
+		zassert_equal(event->val, realtime_cnt,
+			      "Incorrect event order");
+		realtime_cnt++;
+
+		if (realtime_cnt == TEST_REALTIME_EVENT_CNT) {
+			k_sem_give(&realtime_sem);
+		}
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE(MODULE, realtime_event);
+EVENT_SUBSCRIBE(MODULE, bulk_event);
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <bench_events.h>
+
+#include "test_config.h"
+
+#define MODULE test_dispatch
+
+
+enum bench_stage {
+	BENCH_STAGE_SUBS1,
+	BENCH_STAGE_SUBS8,
+	BENCH_STAGE_SUBS32,
+
+	BENCH_STAGE_CNT
+};
+
+static const u32_t stage_subs_cnt[] = {
+	[BENCH_STAGE_SUBS1] = 1,
+	[BENCH_STAGE_SUBS8] = 8,
+	[BENCH_STAGE_SUBS32] = 32,
+};
+
+static enum test_id cur_test_id;
+static enum bench_stage cur_stage;
+static u32_t notify_cnt;
+static u32_t start_cycles;
+static bool mask_check;
+
+
+static bool bench_handler(const struct event_header *eh);
+
+/* Listener 0 is subscribed to all benchmark events, listeners 1 to 7 to
+ * events with 8 and 32 subscribers, remaining ones to events with
+ * 32 subscribers.
+ */
+#define BENCH_LISTENER(id) \
+	EVENT_LISTENER(_CONCAT(bench_listener, id), bench_handler); \
+	EVENT_SUBSCRIBE(_CONCAT(bench_listener, id), bench32_event)
+
+#define BENCH_LISTENER_SUBS8(id) \
+	BENCH_LISTENER(id); \
+	EVENT_SUBSCRIBE(_CONCAT(bench_listener, id), bench8_event)
+
+BENCH_LISTENER_SUBS8(0);
+EVENT_SUBSCRIBE(bench_listener0, bench1_event);
+BENCH_LISTENER_SUBS8(1);
+BENCH_LISTENER_SUBS8(2);
+BENCH_LISTENER_SUBS8(3);
+BENCH_LISTENER_SUBS8(4);
+BENCH_LISTENER_SUBS8(5);
+BENCH_LISTENER_SUBS8(6);
+BENCH_LISTENER_SUBS8(7);
+BENCH_LISTENER(8);
+BENCH_LISTENER(9);
+BENCH_LISTENER(10);
+BENCH_LISTENER(11);
+BENCH_LISTENER(12);
+BENCH_LISTENER(13);
+BENCH_LISTENER(14);
+BENCH_LISTENER(15);
+BENCH_LISTENER(16);
+BENCH_LISTENER(17);
+BENCH_LISTENER(18);
+BENCH_LISTENER(19);
+BENCH_LISTENER(20);
+BENCH_LISTENER(21);
+BENCH_LISTENER(22);
+BENCH_LISTENER(23);
+BENCH_LISTENER(24);
+BENCH_LISTENER(25);
+BENCH_LISTENER(26);
+BENCH_LISTENER(27);
+BENCH_LISTENER(28);
+BENCH_LISTENER(29);
+BENCH_LISTENER(30);
+BENCH_LISTENER(31);
+
+
+static struct event_header *new_stage_event(enum bench_stage stage)
+{
+	switch (stage) {
+	case BENCH_STAGE_SUBS1:
+		return &new_bench1_event()->header;
+	case BENCH_STAGE_SUBS8:
+		return &new_bench8_event()->header;
+	case BENCH_STAGE_SUBS32:
+		return &new_bench32_event()->header;
+	default:
+		zassert_true(false, "Invalid stage");
+		return NULL;
+	}
+}
+
+static void start_stage(enum bench_stage stage)
+{
+	cur_stage = stage;
+	notify_cnt = 0;
+
+	/* Events are queued and dispatched after this handler returns. */
+	for (size_t i = 0; i < TEST_DISPATCH_EVENT_CNT; i++) {
+		_event_submit(new_stage_event(stage));
+	}
+
+	start_cycles = k_cycle_get_32();
+}
+
+static void start_mask_check(void)
+{
+	int err = event_manager_listener_enable(
+			EVENT_LISTENER_GET(bench_listener0), false);
+
+	if (err == -ENOTSUP) {
+		struct test_end_event *te = new_test_end_event();
+
+		te->test_id = cur_test_id;
+		EVENT_SUBMIT(te);
+		return;
+	}
+
+	zassert_equal(err, 0, "Cannot disable listener");
+	zassert_false(event_manager_listener_is_enabled(
+			EVENT_LISTENER_GET(bench_listener0)),
+		      "Listener not disabled");
+
+	mask_check = true;
+	notify_cnt = 0;
+
+	struct bench8_event *event = new_bench8_event();
+
+	EVENT_SUBMIT(event);
+
+	/* Disabled listener must be skipped before test end is received. */
+	struct test_end_event *te = new_test_end_event();
+
+	te->test_id = cur_test_id;
+	EVENT_SUBMIT(te);
+}
+
+static void end_mask_check(void)
+{
+	zassert_equal(notify_cnt, stage_subs_cnt[BENCH_STAGE_SUBS8] - 1,
+		      "Disabled listener notified");
+
+	int err = event_manager_listener_enable(
+			EVENT_LISTENER_GET(bench_listener0), true);
+
+	zassert_equal(err, 0, "Cannot enable listener");
+	mask_check = false;
+}
+
+static bool bench_handler(const struct event_header *eh)
+{
+	if (cur_test_id != TEST_DISPATCH_BENCH) {
+		return false;
+	}
+
+	notify_cnt++;
+
+	if (mask_check) {
+		return false;
+	}
+
+	if (notify_cnt == TEST_DISPATCH_EVENT_CNT * stage_subs_cnt[cur_stage]) {
+		u32_t cycles = k_cycle_get_32() - start_cycles;
+
+		TC_PRINT("%u subscribers: %u cycles per dispatch\n",
+			 stage_subs_cnt[cur_stage],
+			 cycles / TEST_DISPATCH_EVENT_CNT);
+
+		if (cur_stage + 1 < BENCH_STAGE_CNT) {
+			start_stage(cur_stage + 1);
+		} else {
+			start_mask_check();
+		}
+	}
+
+	return false;
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		cur_test_id = st->test_id;
+
+		if (cur_test_id == TEST_DISPATCH_BENCH) {
+			start_stage(BENCH_STAGE_SUBS1);
+		}
+
+		return false;
+	}
+
+	if (is_test_end_event(eh)) {
+		if (mask_check) {
+			end_mask_check();
+		}
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE_EARLY(MODULE, test_end_event);
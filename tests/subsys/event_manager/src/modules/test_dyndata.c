@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <dyndata_event.h>
+
+#include "test_config.h"
+
+#define MODULE test_dyndata
+
+#if CONFIG_DESKTOP_EVENT_MANAGER_ALLOC_POOL
+/* Freed blocks can be counted only if events are allocated from pools. */
+#define FREE_CHECKED true
+#else
+#define FREE_CHECKED false
+#endif
+
+
+static enum test_id cur_test_id;
+static const struct dyndata_event *kept_event;
+
+
+static void check_event(const struct dyndata_event *event)
+{
+	zassert_equal(event->val, TEST_DYNDATA_VAL, "Wrong value");
+	zassert_equal(event->dyndata.size, TEST_DYNDATA_SIZE, "Wrong size");
+
+	for (size_t i = 0; i < TEST_DYNDATA_SIZE; i++) {
+		zassert_equal(event->dyndata.data[i], i, "Wrong data");
+	}
+}
+
+/* Number of pool blocks in use, zero if events are allocated from heap. */
+static u32_t pool_used_get(void)
+{
+	struct event_manager_pool_stats stats;
+	u32_t used = 0;
+
+	for (size_t i = 0; !event_manager_pool_stats_get(i, &stats); i++) {
+		used += stats.used;
+	}
+
+	return used;
+}
+
+static void start_test(void)
+{
+	struct dyndata_event *event = new_dyndata_event(TEST_DYNDATA_SIZE);
+
+	event->val = TEST_DYNDATA_VAL;
+
+	for (size_t i = 0; i < TEST_DYNDATA_SIZE; i++) {
+		event->dyndata.data[i] = i;
+	}
+
+	EVENT_SUBMIT(event);
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		switch (st->test_id) {
+		case TEST_DYNDATA:
+		{
+			cur_test_id = st->test_id;
+			start_test();
+			break;
+		}
+
+		default:
+			/* Ignore other test cases, check if proper test_id. */
+			zassert_true(st->test_id < TEST_CNT,
+				     "test_id out of range");
+			break;
+		}
+
+		return false;
+	}
+
+	if (is_dyndata_event(eh)) {
+		const struct dyndata_event *event = cast_dyndata_event(eh);
+
+		check_event(event);
+
+		/* Keep the event after the notification. */
+		event_manager_event_ref(eh);
+		kept_event = event;
+
+		struct test_end_event *te = new_test_end_event();
+
+		te->test_id = cur_test_id;
+		EVENT_SUBMIT(te);
+
+		return false;
+	}
+
+	if (is_test_end_event(eh)) {
+		if (cur_test_id == TEST_DYNDATA) {
+			zassert_not_null(kept_event, "Event not received");
+
+			/* Event must still be valid. */
+			check_event(kept_event);
+
+			u32_t used = pool_used_get();
+
+			event_manager_event_unref(&kept_event->header);
+			kept_event = NULL;
+
+			/* Block is freed when the last reference is dropped,
+			 * not when the listeners return.
+			 */
+			zassert_true(!FREE_CHECKED ||
+				     (pool_used_get() == used - 1),
+				     "Event not freed on unref");
+			cur_test_id = TEST_IDLE;
+		}
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE(MODULE, dyndata_event);
+EVENT_SUBSCRIBE_EARLY(MODULE, test_end_event);
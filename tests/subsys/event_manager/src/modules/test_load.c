@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <load_event.h>
+
+#include "test_config.h"
+
+#define MODULE test_load
+#define THREAD_STACK_SIZE 512
+#define THREAD_PRIORITY K_PRIO_PREEMPT(1)
+
+
+static K_SEM_DEFINE(burst_sem, 0, 1);
+static K_THREAD_STACK_DEFINE(thread_stack, THREAD_STACK_SIZE);
+
+static struct k_thread thread;
+static enum test_id cur_test_id;
+static u32_t received_cnt;
+
+
+static void check_pool_stats(void)
+{
+	struct event_manager_pool_stats stats;
+	bool pool_used = false;
+
+	for (size_t i = 0; !event_manager_pool_stats_get(i, &stats); i++) {
+		zassert_true(stats.max_used <= stats.block_cnt,
+			     "Pool usage exceeds pool size");
+		pool_used = pool_used || (stats.max_used > 0);
+	}
+
+	if (IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_ALLOC_POOL)) {
+		zassert_true(pool_used, "Event pools not used");
+	}
+}
+
+static void thread_fn(void)
+{
+	u32_t val = 0;
+
+	for (size_t round = 0; round < TEST_LOAD_ROUND_CNT; round++) {
+		for (size_t i = 0; i < TEST_LOAD_BURST_CNT; i++) {
+			struct load_event *event = new_load_event();
+
+			event->val = val;
+			val++;
+			EVENT_SUBMIT(event);
+		}
+
+		int err = k_sem_take(&burst_sem, K_SECONDS(1));
+
+		zassert_equal(err, 0, "Burst not processed");
+	}
+
+	check_pool_stats();
+
+	struct test_end_event *te = new_test_end_event();
+
+	te->test_id = cur_test_id;
+	EVENT_SUBMIT(te);
+}
+
+static void start_test(void)
+{
+	received_cnt = 0;
+
+	k_thread_create(&thread, thread_stack,
+			THREAD_STACK_SIZE,
+			(k_thread_entry_t)thread_fn,
+			NULL, NULL, NULL,
+			THREAD_PRIORITY, 0, K_NO_WAIT);
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		switch (st->test_id) {
+		case TEST_SUSTAINED_LOAD:
+		{
+			cur_test_id = st->test_id;
+			start_test();
+
+			break;
+		}
+
+		default:
+			/* Ignore other test cases, check if proper test_id. */
+			zassert_true(st->test_id < TEST_CNT,
+				     "test_id out of range");
+			break;
+		}
+
+		return false;
+	}
+
+	if (is_load_event(eh)) {
+		struct load_event *event = cast_load_event(eh);
+
+		zassert_equal(event->val, received_cnt,
+			      "Incorrect event order");
+		received_cnt++;
+
+		if ((received_cnt % TEST_LOAD_BURST_CNT) == 0) {
+			k_sem_give(&burst_sem);
+		}
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE(MODULE, load_event);
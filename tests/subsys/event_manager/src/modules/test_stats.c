@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#include <test_events.h>
+#include <stats_event.h>
+
+#include "test_config.h"
+
+#define MODULE test_stats
+
+
+static enum test_id cur_test_id;
+static u32_t received_cnt;
+static const struct event_type *stats_event_type;
+
+
+static bool event_handler(const struct event_header *eh);
+
+EVENT_LISTENER(MODULE, event_handler);
+
+
+static void start_test(void)
+{
+	received_cnt = 0;
+	event_manager_stats_reset();
+
+	/* All events are queued before the first one is processed. */
+	for (size_t i = 0; i < TEST_STATS_EVENT_CNT; i++) {
+		struct stats_event *event = new_stats_event();
+
+		event->val = i;
+		EVENT_SUBMIT(event);
+	}
+}
+
+static void check_stats(void)
+{
+	struct event_type_stats type_stats;
+	struct event_listener_stats listener_stats;
+	int err;
+
+	err = event_manager_type_stats_get(stats_event_type, &type_stats);
+
+	if (!IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_STATS)) {
+		zassert_equal(err, -ENOTSUP, "Statistics not disabled");
+		return;
+	}
+
+	zassert_equal(err, 0, "Cannot get event statistics");
+	zassert_equal(type_stats.submitted, TEST_STATS_EVENT_CNT,
+		      "Wrong number of submitted events");
+	zassert_equal(type_stats.delivered, TEST_STATS_EVENT_CNT,
+		      "Wrong number of delivered events");
+	zassert_equal(type_stats.consumed, 0,
+		      "Wrong number of consumed events");
+	zassert_equal(type_stats.max_queue_depth, TEST_STATS_EVENT_CNT,
+		      "Wrong queue depth");
+	zassert_true(type_stats.latency_min <= type_stats.latency_max,
+		     "Wrong latency");
+
+	u32_t hist_cnt = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(type_stats.latency_hist); i++) {
+		hist_cnt += type_stats.latency_hist[i];
+	}
+
+	zassert_equal(hist_cnt, TEST_STATS_EVENT_CNT, "Wrong histogram");
+
+	err = event_manager_listener_stats_get(EVENT_LISTENER_GET(MODULE),
+					       &listener_stats);
+
+	/* Test start event is counted as well. */
+	zassert_equal(err, 0, "Cannot get listener statistics");
+	zassert_equal(listener_stats.notification_cnt,
+		      TEST_STATS_EVENT_CNT + 1,
+		      "Wrong number of notifications");
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		switch (st->test_id) {
+		case TEST_STATS:
+		{
+			cur_test_id = st->test_id;
+			start_test();
+			break;
+		}
+
+		default:
+			/* Ignore other test cases, check if proper test_id. */
+			zassert_true(st->test_id < TEST_CNT,
+				     "test_id out of range");
+			break;
+		}
+
+		return false;
+	}
+
+	if (is_stats_event(eh)) {
+		struct stats_event *event = cast_stats_event(eh);
+
+		stats_event_type = eh->type_id;
+
+		zassert_equal(event->val, received_cnt,
+			      "Incorrect event order");
+		received_cnt++;
+
+		if (received_cnt == TEST_STATS_EVENT_CNT) {
+			struct test_end_event *te = new_test_end_event();
+
+			te->test_id = cur_test_id;
+			EVENT_SUBMIT(te);
+		}
+
+		return false;
+	}
+
+	if (is_test_end_event(eh)) {
+		if (cur_test_id == TEST_STATS) {
+			check_stats();
+			cur_test_id = TEST_IDLE;
+		}
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE(MODULE, stats_event);
+EVENT_SUBSCRIBE_EARLY(MODULE, test_end_event);
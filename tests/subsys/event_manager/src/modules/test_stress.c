@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2019 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-BSD-5-Clause-Nordic
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <string.h>
+
+#include <test_events.h>
+#include <stress_event.h>
+
+#include "test_config.h"
+
+#define MODULE test_stress
+#define THREAD_STACK_SIZE 512
+#define THREAD_PRIORITY K_PRIO_PREEMPT(1)
+#define THREAD_YIELD_PERIOD 16
+
+/* Last source is the timer ISR. */
+#define SOURCE_ISR TEST_STRESS_THREAD_CNT
+#define SOURCE_CNT (TEST_STRESS_THREAD_CNT + 1)
+
+#define EVENT_CNT (TEST_STRESS_THREAD_CNT * TEST_STRESS_THREAD_EVENT_CNT + \
+		   TEST_STRESS_ISR_EVENT_CNT)
+
+
+static void timer_handler(struct k_timer *timer_id);
+
+static K_TIMER_DEFINE(stress_timer, timer_handler, NULL);
+static K_THREAD_STACK_ARRAY_DEFINE(thread_stacks, TEST_STRESS_THREAD_CNT,
+				   THREAD_STACK_SIZE);
+
+static struct k_thread threads[TEST_STRESS_THREAD_CNT];
+static enum test_id cur_test_id;
+static u32_t isr_seq;
+static u32_t next_seq[SOURCE_CNT];
+static u32_t received_cnt;
+static u32_t start_cycles;
+
+
+static void send_event(u8_t source, u32_t seq)
+{
+	struct stress_event *event = new_stress_event();
+
+	event->source = source;
+	event->seq = seq;
+	EVENT_SUBMIT(event);
+}
+
+static void timer_handler(struct k_timer *timer_id)
+{
+	send_event(SOURCE_ISR, isr_seq);
+	isr_seq++;
+
+	if (isr_seq == TEST_STRESS_ISR_EVENT_CNT) {
+		k_timer_stop(&stress_timer);
+	}
+}
+
+static void thread_fn(void *p1, void *p2, void *p3)
+{
+	u8_t source = (u8_t)(uintptr_t)p1;
+
+	for (u32_t seq = 0; seq < TEST_STRESS_THREAD_EVENT_CNT; seq++) {
+		send_event(source, seq);
+
+		/* Let other producers interleave with this one. */
+		if ((seq % THREAD_YIELD_PERIOD) == 0) {
+			k_yield();
+		}
+	}
+}
+
+static void start_test(void)
+{
+	isr_seq = 0;
+	received_cnt = 0;
+	memset(next_seq, 0, sizeof(next_seq));
+	start_cycles = k_cycle_get_32();
+
+	k_timer_start(&stress_timer, TEST_STRESS_ISR_PERIOD,
+		      TEST_STRESS_ISR_PERIOD);
+
+	for (size_t i = 0; i < ARRAY_SIZE(threads); i++) {
+		k_thread_create(&threads[i], thread_stacks[i],
+				THREAD_STACK_SIZE, thread_fn,
+				(void *)i, NULL, NULL,
+				THREAD_PRIORITY, 0, K_NO_WAIT);
+	}
+}
+
+static void end_test(void)
+{
+	u32_t cycles = k_cycle_get_32() - start_cycles;
+	u64_t time_us = SYS_CLOCK_HW_CYCLES_TO_NS64(cycles) / NSEC_PER_USEC;
+
+	TC_PRINT("%s queue: %u events in %u us (%u events/s)\n",
+		 IS_ENABLED(CONFIG_DESKTOP_EVENT_MANAGER_LOCKFREE_QUEUE) ?
+			"lock-free" : "spinlock",
+		 EVENT_CNT, (u32_t)time_us,
+		 (time_us > 0) ?
+			(u32_t)((u64_t)EVENT_CNT * USEC_PER_SEC / time_us) :
+			0);
+
+	struct test_end_event *te = new_test_end_event();
+
+	te->test_id = cur_test_id;
+	EVENT_SUBMIT(te);
+}
+
+static bool event_handler(const struct event_header *eh)
+{
+	if (is_test_start_event(eh)) {
+		struct test_start_event *st = cast_test_start_event(eh);
+
+		switch (st->test_id) {
+		case TEST_STRESS:
+		{
+			cur_test_id = st->test_id;
+			start_test();
+			break;
+		}
+
+		default:
+			/* Ignore other test cases, check if proper test_id. */
+			zassert_true(st->test_id < TEST_CNT,
+				     "test_id out of range");
+			break;
+		}
+
+		return false;
+	}
+
+	if (is_stress_event(eh)) {
+		struct stress_event *event = cast_stress_event(eh);
+
+		zassert_true(event->source < SOURCE_CNT, "Invalid source");
+
+		/* Events from one source must keep the submission order. */
+		zassert_equal(event->seq, next_seq[event->source],
+			      "Incorrect event order");
+		next_seq[event->source]++;
+		received_cnt++;
+
+		if (received_cnt == EVENT_CNT) {
+			end_test();
+		}
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+EVENT_LISTENER(MODULE, event_handler);
+EVENT_SUBSCRIBE(MODULE, test_start_event);
+EVENT_SUBSCRIBE(MODULE, stress_event);